@@ -0,0 +1,69 @@
+#include "AllocCheck.h"
+#include <stdexcept>
+
+namespace {
+    // from֮"key":ȡ/admin/allocGateServerJsonWriterûпհ
+    std::uint64_t ReadNumber(const std::string& body, std::size_t from, const char* key) {
+        std::string pattern = std::string("\"") + key + "\":";
+        auto pos = body.find(pattern, from);
+        if (pos == std::string::npos) {
+            throw std::runtime_error(std::string("/admin/alloc has no field ") + key);
+        }
+        return std::strtoull(body.c_str() + pos + pattern.size(), nullptr, 10);
+    }
+}
+
+AllocSnapshot AllocSnapshot::Fetch(const BenchConfig& cfg)
+{
+    net::io_context ioc;
+    tcp::resolver resolver(ioc);
+    beast::tcp_stream stream(ioc);
+    stream.connect(resolver.resolve(cfg.host, cfg.port));
+
+    http::request<http::empty_body> req(http::verb::get, "/admin/alloc", 11);
+    req.set(http::field::host, cfg.host);
+    req.keep_alive(false);
+    http::write(stream, req);
+
+    beast::flat_buffer buffer;
+    http::response<http::string_body> rsp;
+    http::read(stream, buffer, rsp);
+    beast::error_code ec;
+    stream.socket().shutdown(tcp::socket::shutdown_both, ec);
+    if (rsp.result() != http::status::ok) {
+        throw std::runtime_error("GET /admin/alloc returned " + std::to_string(rsp.result_int()));
+    }
+
+    const std::string& body = rsp.body();
+    AllocSnapshot snapshot;
+    snapshot.enabled = body.find("\"enabled\":true") != std::string::npos;
+    for (int i = 0; i < ROUTES; ++i) {
+        std::string route = std::string("\"route\":\"") + RouteServerName(static_cast<BenchRoute>(i)) + "\"";
+        auto pos = body.find(route);
+        if (pos == std::string::npos) {
+            continue;
+        }
+        snapshot.requests[i] = ReadNumber(body, pos, "requests");
+        snapshot.allocations[i] = ReadNumber(body, pos, "allocations");
+        snapshot.bytes[i] = ReadNumber(body, pos, "bytes");
+    }
+    return snapshot;
+}
+
+AllocResult AllocResult::Compare(const BenchConfig& cfg, const AllocSnapshot& before, const AllocSnapshot& after)
+{
+    AllocResult result;
+    for (int i = 0; i < ROUTES; ++i) {
+        auto requests = after.requests[i] - before.requests[i];
+        if (requests == 0) {
+            continue;
+        }
+        result.measured[i] = true;
+        result.allocations[i] = static_cast<double>(after.allocations[i] - before.allocations[i]) / static_cast<double>(requests);
+        result.bytes[i] = static_cast<double>(after.bytes[i] - before.bytes[i]) / static_cast<double>(requests);
+        if (cfg.alloc_budget[i] > 0 && result.allocations[i] > cfg.alloc_budget[i]) {
+            result.over_budget = true;
+        }
+    }
+    return result;
+}
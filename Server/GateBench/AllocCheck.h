@@ -0,0 +1,28 @@
+#pragma once
+#include "const.h"
+#include "BenchConfig.h"
+
+// GateServerGET /admin/allocи͵ۼƶѷ
+struct AllocSnapshot {
+    static constexpr int ROUTES = static_cast<int>(BenchRoute::Count);
+
+    bool enabled = false;               // GateServerǷGATE_ALLOC_PROFILE
+    std::uint64_t requests[ROUTES] = {};
+    std::uint64_t allocations[ROUTES] = {};
+    std::uint64_t bytes[ROUTES] = {};
+
+    // ͬһ/admin/allocӻʧ׳쳣
+    static AllocSnapshot Fetch(const BenchConfig& cfg);
+};
+
+// ѹǰο֮ѹڼ䣨Ԥȣÿƽ
+struct AllocResult {
+    static constexpr int ROUTES = AllocSnapshot::ROUTES;
+
+    bool measured[ROUTES] = {};         // ѹڼ
+    double allocations[ROUTES] = {};
+    double bytes[ROUTES] = {};
+    bool over_budget = false;           // ͳAllocBudget
+
+    static AllocResult Compare(const BenchConfig& cfg, const AllocSnapshot& before, const AllocSnapshot& after);
+};
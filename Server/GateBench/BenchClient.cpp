@@ -0,0 +1,153 @@
+#include "BenchClient.h"
+
+namespace {
+    std::uint64_t Nanos(Clock::duration duration) {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+        return ns > 0 ? static_cast<std::uint64_t>(ns) : 0;
+    }
+}
+
+void BenchStats::Merge(const BenchStats& other)
+{
+    latency.Merge(other.latency);
+    service.Merge(other.service);
+    connect.Merge(other.connect);
+    for (int i = 0; i < ROUTES; ++i) {
+        route_latency[i].Merge(other.route_latency[i]);
+        requests[i] += other.requests[i];
+        http_errors[i] += other.http_errors[i];
+        app_errors[i] += other.app_errors[i];
+    }
+    io_errors += other.io_errors;
+    connects += other.connects;
+    connect_errors += other.connect_errors;
+    bytes_sent += other.bytes_sent;
+    bytes_received += other.bytes_received;
+}
+
+BenchClient::BenchClient(net::io_context& ioc, const tcp::resolver::results_type& endpoints, const BenchConfig& cfg,
+    Workload& workload, BenchStats& stats, const BenchSchedule& schedule,
+    Clock::time_point first_send, std::uint64_t seed)
+    : _stream(ioc), _endpoints(endpoints), _cfg(cfg), _workload(workload), _stats(stats),
+    _schedule(schedule), _next_send(first_send), _rng(seed ? seed : 1)
+{
+
+}
+
+void BenchClient::Start()
+{
+    auto self = shared_from_this();
+    net::co_spawn(_stream.get_executor(), [self]() { return self->Run(); }, net::detached);
+}
+
+net::awaitable<bool> BenchClient::Connect(bool measured)
+{
+    auto begin = Clock::now();
+    try {
+        _stream.expires_after(REQUEST_TIMEOUT);
+        co_await _stream.async_connect(_endpoints, net::use_awaitable);
+        _stream.socket().set_option(tcp::no_delay(true));
+    }
+    catch (boost::system::system_error&) {
+        if (measured) {
+            ++_stats.connect_errors;
+        }
+        Close();
+        co_return false;
+    }
+    if (measured) {
+        ++_stats.connects;
+        _stats.connect.Record(Nanos(Clock::now() - begin));
+    }
+    _connected = true;
+    co_return true;
+}
+
+void BenchClient::Close()
+{
+    beast::error_code ec;
+    _stream.socket().shutdown(tcp::socket::shutdown_both, ec);
+    _stream.socket().close(ec);
+    _buffer.clear();
+    _connected = false;
+}
+
+net::awaitable<void> BenchClient::Run()
+{
+    net::steady_timer timer(_stream.get_executor());
+    bool open_loop = _cfg.open_loop;
+    while (true) {
+        // ģʽȵƻʱٷջģʽļƻʱ
+        Clock::time_point intended = open_loop ? _next_send : Clock::now();
+        if (intended >= _schedule.end) {
+            break;
+        }
+        if (open_loop) {
+            _next_send += _schedule.interval;
+            if (intended > Clock::now()) {
+                timer.expires_at(intended);
+                co_await timer.async_wait(net::use_awaitable);
+            }
+        }
+        bool measured = intended >= _schedule.measure_start;
+
+        if (!_connected && !co_await Connect(measured)) {
+            // ˲ʱջģʽԵתģʽƻ
+            if (!open_loop) {
+                timer.expires_after(std::chrono::milliseconds(10));
+                co_await timer.async_wait(net::use_awaitable);
+            }
+            continue;
+        }
+
+        auto route = _workload.Pick(_rng);
+        _workload.Build(route, _request);
+        _response = {};
+        auto sent = Clock::now();
+        std::size_t bytes_sent = 0;
+        std::size_t bytes_received = 0;
+        try {
+            _stream.expires_after(REQUEST_TIMEOUT);
+            bytes_sent = co_await http::async_write(_stream, _request, net::use_awaitable);
+            bytes_received = co_await http::async_read(_stream, _buffer, _response, net::use_awaitable);
+        }
+        catch (boost::system::system_error&) {
+            if (measured) {
+                ++_stats.io_errors;
+            }
+            Close();
+            continue;
+        }
+        auto done = Clock::now();
+
+        if (measured) {
+            int index = static_cast<int>(route);
+            ++_stats.requests[index];
+            if (_response.result() != http::status::ok) {
+                ++_stats.http_errors[index];
+            }
+            else if (!Workload::Succeeded(route, _response)) {
+                ++_stats.app_errors[index];
+            }
+            _stats.bytes_sent += bytes_sent;
+            _stats.bytes_received += bytes_received;
+
+            auto latency = Nanos(done - intended);
+            if (open_loop) {
+                _stats.latency.Record(latency);
+                _stats.route_latency[index].Record(latency);
+            }
+            else {
+                auto interval = Nanos(_schedule.interval);
+                _stats.latency.RecordCorrected(latency, interval);
+                _stats.route_latency[index].RecordCorrected(latency, interval);
+            }
+            _stats.service.Record(Nanos(done - sent));
+        }
+
+        if (!_cfg.keep_alive || !_response.keep_alive()) {
+            Close();
+        }
+    }
+    Close();
+}
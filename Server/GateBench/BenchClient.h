@@ -0,0 +1,65 @@
+#pragma once
+#include "const.h"
+#include "BenchConfig.h"
+#include "LatencyHistogram.h"
+#include "Workload.h"
+
+// һio߳ӹõͳƣֻڸ߳޸ģѹϲ
+struct BenchStats {
+    static constexpr int ROUTES = static_cast<int>(BenchRoute::Count);
+
+    LatencyHistogram latency;           // ӳ٣Ӽƻʱ𣬱ջЭ©
+    LatencyHistogram service;           // δӳ٣ʵʷӦ
+    LatencyHistogram connect;           // TCPӵĺʱ
+    LatencyHistogram route_latency[ROUTES];
+    std::uint64_t requests[ROUTES] = {};
+    std::uint64_t http_errors[ROUTES] = {};     // ״̬벻200
+    std::uint64_t app_errors[ROUTES] = {};      // ״̬200jsonerrorΪ0
+    std::uint64_t io_errors = 0;                // дʧܻʱ
+    std::uint64_t connects = 0;
+    std::uint64_t connect_errors = 0;
+    std::uint64_t bytes_sent = 0;
+    std::uint64_t bytes_received = 0;
+
+    void Merge(const BenchStats& other);
+};
+
+// ѹʱ䰲ţӹ
+struct BenchSchedule {
+    Clock::time_point measure_start;    // ԤȽ֮ƻ͵
+    Clock::time_point end;              // ֮ٷ
+    Clock::duration interval{ 0 };      // ÿӵļƻͼջδRateʱΪ0
+};
+
+// һѹӣio߳Эѭ
+// ģʽƻʱ䷢ͣڼƻʱͣӳٴӼƻʱ
+// ջģʽյӦһ
+class BenchClient : public std::enable_shared_from_this<BenchClient>
+{
+public:
+    BenchClient(net::io_context& ioc, const tcp::resolver::results_type& endpoints, const BenchConfig& cfg,
+        Workload& workload, BenchStats& stats, const BenchSchedule& schedule,
+        Clock::time_point first_send, std::uint64_t seed);
+
+    void Start();
+
+private:
+    net::awaitable<void> Run();
+    net::awaitable<bool> Connect(bool measured);
+    void Close();
+
+    static constexpr std::chrono::seconds REQUEST_TIMEOUT{ 10 };
+
+    beast::tcp_stream _stream;
+    beast::flat_buffer _buffer;
+    http::request<http::string_body> _request;
+    http::response<http::string_body> _response;
+    const tcp::resolver::results_type& _endpoints;
+    const BenchConfig& _cfg;
+    Workload& _workload;
+    BenchStats& _stats;
+    const BenchSchedule& _schedule;
+    Clock::time_point _next_send;
+    std::uint64_t _rng;
+    bool _connected = false;
+};
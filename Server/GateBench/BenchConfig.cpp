@@ -0,0 +1,170 @@
+#include "BenchConfig.h"
+#include <boost/filesystem.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/ini_parser.hpp>
+#include <map>
+#include <stdexcept>
+
+const char* RouteName(BenchRoute route)
+{
+    switch (route) {
+    case BenchRoute::GetTest:       return "get_test";
+    case BenchRoute::GetVerifyCode: return "get_verifycode";
+    case BenchRoute::UserRegister:  return "user_register";
+    default:                        return "unknown";
+    }
+}
+
+const char* RouteServerName(BenchRoute route)
+{
+    switch (route) {
+    case BenchRoute::GetTest:       return "GET /get_test";
+    case BenchRoute::GetVerifyCode: return "POST /get_verifycode";
+    case BenchRoute::UserRegister:  return "POST /user_register";
+    default:                        return "unknown";
+    }
+}
+
+namespace {
+    bool ParseBool(const std::string& value) {
+        return value == "true" || value == "1";
+    }
+
+    // Mix = get_test:8,get_verifycode:1,user_register:1
+    // AllocBudget = get_test:30,user_register:200 ҲͬĸʽkeyΪڴϢ
+    void ParseMix(const std::string& mix, double* weights, const std::string& key = "Mix") {
+        for (int i = 0; i < static_cast<int>(BenchRoute::Count); ++i) {
+            weights[i] = 0;
+        }
+        std::size_t pos = 0;
+        while (pos < mix.size()) {
+            std::size_t end = mix.find(',', pos);
+            if (end == std::string::npos) {
+                end = mix.size();
+            }
+            std::string item = mix.substr(pos, end - pos);
+            pos = end + 1;
+            auto colon = item.find(':');
+            std::string name = item.substr(0, colon);
+            double weight = colon == std::string::npos ? 1 : std::stod(item.substr(colon + 1));
+            bool found = false;
+            for (int i = 0; i < static_cast<int>(BenchRoute::Count); ++i) {
+                if (name == RouteName(static_cast<BenchRoute>(i))) {
+                    weights[i] = weight;
+                    found = true;
+                }
+            }
+            if (!found) {
+                throw std::invalid_argument("unknown route in " + key + ": " + name);
+            }
+        }
+    }
+}
+
+BenchConfig BenchConfig::Load(int argc, char* argv[])
+{
+    std::map<std::string, std::string> bench;
+    std::map<std::string, std::string> redis;
+
+    boost::filesystem::path config_path = boost::filesystem::current_path() / "config.ini";
+    if (boost::filesystem::exists(config_path)) {
+        boost::property_tree::ptree pt;
+        boost::property_tree::read_ini(config_path.string(), pt);
+        for (const auto& section_pair : pt) {
+            if (section_pair.first != "Bench" && section_pair.first != "Redis") {
+                continue;
+            }
+            auto& target = section_pair.first == "Bench" ? bench : redis;
+            for (const auto& key_value_pair : section_pair.second) {
+                target[key_value_pair.first] = key_value_pair.second.get_value<std::string>();
+            }
+        }
+    }
+
+    // вļ GateBench Mode=open Rate=20000
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto eq = arg.find('=');
+        if (eq == std::string::npos) {
+            throw std::invalid_argument("argument should be Key=Value: " + arg);
+        }
+        bench[arg.substr(0, eq)] = arg.substr(eq + 1);
+    }
+
+    BenchConfig cfg;
+    auto get = [&bench](const char* key) -> std::string {
+        auto iter = bench.find(key);
+        return iter == bench.end() ? std::string() : iter->second;
+    };
+    std::string value;
+    if (!(value = get("Host")).empty()) cfg.host = value;
+    if (!(value = get("Port")).empty()) cfg.port = value;
+    if (!(value = get("Threads")).empty()) cfg.threads = std::stoul(value);
+    if (!(value = get("Connections")).empty()) cfg.connections = std::stoul(value);
+    if (!(value = get("Mode")).empty()) {
+        if (value != "open" && value != "closed") {
+            throw std::invalid_argument("Mode should be open or closed");
+        }
+        cfg.open_loop = value == "open";
+    }
+    if (!(value = get("Rate")).empty()) cfg.rate = std::stod(value);
+    if (!(value = get("Duration")).empty()) cfg.duration = std::chrono::seconds(std::stol(value));
+    if (!(value = get("Warmup")).empty()) cfg.warmup = std::chrono::seconds(std::stol(value));
+    if (!(value = get("KeepAlive")).empty()) cfg.keep_alive = ParseBool(value);
+    if (!(value = get("Mix")).empty()) ParseMix(value, cfg.weights);
+    if (!(value = get("Padding")).empty()) cfg.padding = std::stoul(value);
+    if (!(value = get("QueryParams")).empty()) cfg.query_params = std::stoul(value);
+    if (!(value = get("SeedCount")).empty()) cfg.seed_count = std::stoul(value);
+    if (!(value = get("AllocBudget")).empty()) ParseMix(value, cfg.alloc_budget, "AllocBudget");
+    cfg.result_file = get("ResultFile");
+    cfg.label = get("Label");
+
+    if (!redis["Host"].empty()) cfg.redis_host = redis["Host"];
+    if (!redis["Port"].empty()) cfg.redis_port = std::stoi(redis["Port"]);
+    cfg.redis_passwd = redis["Passwd"];
+
+    if (cfg.threads == 0 || cfg.connections == 0) {
+        throw std::invalid_argument("Threads and Connections should be positive");
+    }
+    if (cfg.open_loop && cfg.rate <= 0) {
+        throw std::invalid_argument("open loop mode needs a positive Rate");
+    }
+    if (cfg.TotalWeight() <= 0) {
+        throw std::invalid_argument("Mix should contain at least one route");
+    }
+    return cfg;
+}
+
+std::size_t BenchConfig::RegisterSeedCount() const
+{
+    double share = weights[static_cast<int>(BenchRoute::UserRegister)] / TotalWeight();
+    if (share <= 0) {
+        return 0;
+    }
+    if (seed_count > 0) {
+        return seed_count;
+    }
+    // ջģʽ޷Ԥ֪ʣÿ5㣬ʱע֤ʧܲӦô
+    double rate_estimate = open_loop ? rate : 50000;
+    double total = rate_estimate * static_cast<double>((duration + warmup).count()) * share * 1.1;
+    return static_cast<std::size_t>(total) + connections;
+}
+
+double BenchConfig::TotalWeight() const
+{
+    double total = 0;
+    for (double weight : weights) {
+        total += weight;
+    }
+    return total;
+}
+
+bool BenchConfig::CheckAlloc() const
+{
+    for (double budget : alloc_budget) {
+        if (budget > 0) {
+            return true;
+        }
+    }
+    return false;
+}
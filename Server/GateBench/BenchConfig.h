@@ -0,0 +1,50 @@
+#pragma once
+#include "const.h"
+
+// ѹ
+enum class BenchRoute {
+    GetTest = 0,        // GET /get_test
+    GetVerifyCode,      // POST /get_verifycode
+    UserRegister,       // POST /user_register
+    Count,
+};
+
+const char* RouteName(BenchRoute route);
+// GateServerе·/metrics/admin/allocеһ£"GET /get_test"
+const char* RouteServerName(BenchRoute route);
+
+// ѹȶȡǰĿ¼config.iniе[Bench][Redis]
+// е Key=Value [Bench]еͬ
+struct BenchConfig {
+    std::string host = "127.0.0.1";
+    std::string port = "8080";
+    std::size_t threads = 4;                    // io߳
+    std::size_t connections = 64;               // ƽֵio߳
+    bool open_loop = false;                     // true̶ʷͣfalseյӦһ
+    double rate = 0;                            // ģʽӺϼƵÿ
+    std::chrono::seconds duration{ 30 };        // ѹʱ
+    std::chrono::seconds warmup{ 5 };           // Ԥʱڼ󲻼
+    bool keep_alive = true;                     // falseʱÿ½һ
+    double weights[static_cast<int>(BenchRoute::Count)] = { 1, 0, 0 };  // ͵ռ
+    std::size_t padding = 0;                    // POSTиӵֽԲͬС
+    std::size_t query_params = 0;               // /get_testĲѯ
+    std::size_t seed_count = 0;                 // Ԥдredisע֤0ʾʺʱ
+    std::string result_file;                    // ΪʱѽһJSON׷ӵļȽϲͬ汾
+    std::string label;                          // дļıǩ汾
+    // ÿƽѷ0ʾ飻
+    // ҪGateServerGATE_ALLOC_PROFILEʱGateBenchԷ0˳Ϊع
+    double alloc_budget[static_cast<int>(BenchRoute::Count)] = { 0, 0, 0 };
+
+    std::string redis_host = "127.0.0.1";
+    int redis_port = 6379;
+    std::string redis_passwd;
+
+    static BenchConfig Load(int argc, char* argv[]);
+
+    // עҪ֤
+    std::size_t RegisterSeedCount() const;
+    // ͵ռ֮
+    double TotalWeight() const;
+    // ǷAllocBudget
+    bool CheckAlloc() const;
+};
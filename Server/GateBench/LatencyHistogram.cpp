@@ -0,0 +1,87 @@
+#include "LatencyHistogram.h"
+#include <algorithm>
+#include <bit>
+
+LatencyHistogram::LatencyHistogram()
+    : _buckets(BUCKETS, 0)
+{
+
+}
+
+std::size_t LatencyHistogram::BucketIndex(std::uint64_t value)
+{
+    // С128ֵռһͰ֮ÿ2128Ͱ
+    if (value < SUB_COUNT) {
+        return static_cast<std::size_t>(value);
+    }
+    int msb = 63 - std::countl_zero(value);
+    int shift = msb - SUB_BITS;
+    std::size_t index = static_cast<std::size_t>(shift + 1) * SUB_COUNT
+        + static_cast<std::size_t>((value >> shift) & (SUB_COUNT - 1));
+    return std::min(index, BUCKETS - 1);
+}
+
+std::uint64_t LatencyHistogram::BucketUpperBound(std::size_t index)
+{
+    if (index < SUB_COUNT) {
+        return index;
+    }
+    int shift = static_cast<int>(index / SUB_COUNT) - 1;
+    std::uint64_t sub = index % SUB_COUNT;
+    std::uint64_t lower = (SUB_COUNT + sub) << shift;
+    return lower + (1ull << shift) - 1;
+}
+
+void LatencyHistogram::Record(std::uint64_t value)
+{
+    ++_buckets[BucketIndex(value)];
+    ++_count;
+    _max = std::max(_max, value);
+    _sum += static_cast<double>(value);
+}
+
+void LatencyHistogram::RecordCorrected(std::uint64_t value, std::uint64_t expected_interval)
+{
+    Record(value);
+    if (expected_interval == 0 || value <= expected_interval) {
+        return;
+    }
+    for (std::uint64_t missing = value - expected_interval; missing >= expected_interval; missing -= expected_interval) {
+        Record(missing);
+    }
+}
+
+void LatencyHistogram::Merge(const LatencyHistogram& other)
+{
+    for (std::size_t i = 0; i < BUCKETS; ++i) {
+        _buckets[i] += other._buckets[i];
+    }
+    _count += other._count;
+    _max = std::max(_max, other._max);
+    _sum += other._sum;
+}
+
+double LatencyHistogram::Mean() const
+{
+    return _count == 0 ? 0 : _sum / static_cast<double>(_count);
+}
+
+std::uint64_t LatencyHistogram::Percentile(double q) const
+{
+    if (_count == 0) {
+        return 0;
+    }
+    std::uint64_t target = static_cast<std::uint64_t>(q * static_cast<double>(_count));
+    if (target >= _count) {
+        target = _count - 1;
+    }
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < BUCKETS; ++i) {
+        seen += _buckets[i];
+        if (seen > target) {
+            // ͰϽܳʵʼ¼ֵ
+            return std::min(BucketUpperBound(i), _max);
+        }
+    }
+    return _max;
+}
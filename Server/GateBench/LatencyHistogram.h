@@ -0,0 +1,37 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+// HDRӳֱͼ¼2ݷ飬ÿԷֳ128ͰС1%
+// ÿio̸߳һѹϲ
+class LatencyHistogram
+{
+public:
+    static constexpr int SUB_BITS = 7;
+    static constexpr std::uint64_t SUB_COUNT = 1ull << SUB_BITS;
+    static constexpr int MAX_BITS = 44;          // Լ17000
+    static constexpr std::size_t BUCKETS = (MAX_BITS - SUB_BITS + 1) * SUB_COUNT;
+
+    LatencyHistogram();
+
+    void Record(std::uint64_t value);
+    // Э©valueķͼʱǱסӦӳ
+    // ջģʽʹãģʽƻʱӳ٣ѾŶʱ
+    void RecordCorrected(std::uint64_t value, std::uint64_t expected_interval);
+    void Merge(const LatencyHistogram& other);
+
+    std::uint64_t Count() const { return _count; }
+    std::uint64_t Max() const { return _max; }
+    double Mean() const;
+    // λqȡ01ضӦͰܱʾֵ
+    std::uint64_t Percentile(double q) const;
+
+private:
+    static std::size_t BucketIndex(std::uint64_t value);
+    static std::uint64_t BucketUpperBound(std::size_t index);
+
+    std::vector<std::uint64_t> _buckets;
+    std::uint64_t _count = 0;
+    std::uint64_t _max = 0;
+    double _sum = 0;
+};
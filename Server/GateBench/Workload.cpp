@@ -0,0 +1,173 @@
+#include "Workload.h"
+#include "sw/redis++/redis++.h"
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace {
+    // xorshiftÿio߳һ״̬
+    std::uint64_t NextRandom(std::uint64_t& state) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+
+    std::string RegisterName(const std::string& run_id, std::uint64_t n) {
+        return "bench_" + run_id + "_" + std::to_string(n);
+    }
+}
+
+Workload::Workload(const BenchConfig& cfg)
+    : _cfg(cfg), _padding(cfg.padding, 'x')
+{
+    char buf[32];
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    std::snprintf(buf, sizeof(buf), "%llx",
+        static_cast<unsigned long long>(std::chrono::duration_cast<std::chrono::milliseconds>(now).count()));
+    _run_id = buf;
+    _code = _run_id.substr(_run_id.size() > 6 ? _run_id.size() - 6 : 0);
+
+    double total = cfg.TotalWeight();
+    double sum = 0;
+    for (int i = 0; i < static_cast<int>(BenchRoute::Count); ++i) {
+        sum += cfg.weights[i];
+        _cumulative[i] = sum / total;
+    }
+
+    _target = "/get_test";
+    for (std::size_t i = 0; i < cfg.query_params; ++i) {
+        _target.append(i == 0 ? "?" : "&");
+        _target.append("key").append(std::to_string(i)).append("=value").append(std::to_string(i));
+    }
+}
+
+std::size_t Workload::SeedRedis()
+{
+    std::size_t count = _cfg.RegisterSeedCount();
+    if (count == 0) {
+        return 0;
+    }
+
+    auto* context = redisConnect(_cfg.redis_host.c_str(), _cfg.redis_port);
+    if (context == nullptr || context->err != 0) {
+        std::string err = context ? context->errstr : "alloc failed";
+        if (context) {
+            redisFree(context);
+        }
+        throw std::runtime_error("connect redis failed: " + err);
+    }
+    if (!_cfg.redis_passwd.empty()) {
+        auto reply = (redisReply*)redisCommand(context, "AUTH %s", _cfg.redis_passwd.c_str());
+        bool ok = reply != nullptr && reply->type != REDIS_REPLY_ERROR;
+        if (reply) {
+            freeReplyObject(reply);
+        }
+        if (!ok) {
+            redisFree(context);
+            throw std::runtime_error("redis auth failed");
+        }
+    }
+
+    // ֤ѹڼЧںԶ
+    long long ttl = (_cfg.duration + _cfg.warmup).count() + 600;
+    constexpr std::size_t BATCH = 1000;
+    for (std::size_t begin = 0; begin < count; begin += BATCH) {
+        std::size_t end = std::min(count, begin + BATCH);
+        // һˮ߷ͣȡӦ
+        for (std::size_t n = begin; n < end; ++n) {
+            std::string key = CODEPREFIX + RegisterName(_run_id, n) + "@bench.local";
+            redisAppendCommand(context, "SET %s %s EX %lld", key.c_str(), _code.c_str(), ttl);
+        }
+        for (std::size_t n = begin; n < end; ++n) {
+            void* reply = nullptr;
+            if (redisGetReply(context, &reply) != REDIS_OK) {
+                redisFree(context);
+                throw std::runtime_error("seed redis failed");
+            }
+            freeReplyObject(reply);
+        }
+    }
+    redisFree(context);
+    return count;
+}
+
+BenchRoute Workload::Pick(std::uint64_t& rng) const
+{
+    double r = static_cast<double>(NextRandom(rng) >> 11) * 0x1.0p-53;
+    for (int i = 0; i < static_cast<int>(BenchRoute::Count); ++i) {
+        if (r < _cumulative[i]) {
+            return static_cast<BenchRoute>(i);
+        }
+    }
+    return BenchRoute::GetTest;
+}
+
+std::string Workload::BuildBody(BenchRoute route)
+{
+    std::string body = "{";
+    if (route == BenchRoute::UserRegister) {
+        // Ԥдĸredisû֤룬Щ֤ʧ
+        auto name = RegisterName(_run_id, _next_register.fetch_add(1, std::memory_order_relaxed));
+        body.append("\"email\":\"").append(name).append("@bench.local\",");
+        body.append("\"user\":\"").append(name).append("\",");
+        body.append("\"passwd\":\"bench_pwd\",\"confirm\":\"bench_pwd\",");
+        body.append("\"verifycode\":\"").append(_code).append("\"");
+    }
+    else {
+        auto n = _next_verify.fetch_add(1, std::memory_order_relaxed);
+        body.append("\"email\":\"verify_").append(_run_id).append("_").append(std::to_string(n)).append("@bench.local\"");
+    }
+    if (!_padding.empty()) {
+        body.append(",\"pad\":\"").append(_padding).append("\"");
+    }
+    body.append("}");
+    return body;
+}
+
+void Workload::Build(BenchRoute route, http::request<http::string_body>& req)
+{
+    req = {};
+    req.version(11);
+    req.set(http::field::host, _cfg.host);
+    req.set(http::field::user_agent, "GateBench");
+    req.keep_alive(_cfg.keep_alive);
+    switch (route) {
+    case BenchRoute::GetTest:
+        req.method(http::verb::get);
+        req.target(_target);
+        break;
+    case BenchRoute::GetVerifyCode:
+        req.method(http::verb::post);
+        req.target("/get_verifycode");
+        break;
+    case BenchRoute::UserRegister:
+        req.method(http::verb::post);
+        req.target("/user_register");
+        break;
+    default:
+        break;
+    }
+    if (route != BenchRoute::GetTest) {
+        req.set(http::field::content_type, "application/json");
+        req.body() = BuildBody(route);
+    }
+    req.prepare_payload();
+}
+
+bool Workload::Succeeded(BenchRoute route, const http::response<http::string_body>& rsp)
+{
+    if (rsp.result() != http::status::ok) {
+        return false;
+    }
+    if (route == BenchRoute::GetTest) {
+        return true;
+    }
+    // GateServerյjsonerrorֶ "error":0
+    const auto& body = rsp.body();
+    auto pos = body.find("\"error\":");
+    if (pos == std::string::npos) {
+        return false;
+    }
+    return std::atoi(body.c_str() + pos + 8) == 0;
+}
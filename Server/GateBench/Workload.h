@@ -0,0 +1,36 @@
+#pragma once
+#include "const.h"
+#include "BenchConfig.h"
+#include <atomic>
+
+// ѹ󣺰Mixеռѡͣעʹñѹеû
+// Ӧ֤ѹ⿪ʼǰSeedRedisдGateServerʹõredis
+class Workload
+{
+public:
+    explicit Workload(const BenchConfig& cfg);
+
+    // дעõ֤룬дĸredisʧ׳쳣
+    std::size_t SeedRedis();
+
+    // rngǵ÷߳Լ״̬
+    BenchRoute Pick(std::uint64_t& rng) const;
+    void Build(BenchRoute route, http::request<http::string_body>& req);
+
+    // ӦǷʾҵɹ/get_testֻ״̬룬·ɻҪjsonerrorΪ0
+    static bool Succeeded(BenchRoute route, const http::response<http::string_body>& rsp);
+
+    const std::string& RunId() const { return _run_id; }
+
+private:
+    std::string BuildBody(BenchRoute route);
+
+    const BenchConfig& _cfg;
+    std::string _run_id;                // ֲͬѹ⣬֤ע䲻ظ
+    std::string _code;                  // ѹעʹõ֤
+    std::string _padding;
+    std::string _target;                // /get_testѯĿ
+    double _cumulative[static_cast<int>(BenchRoute::Count)];
+    std::atomic<std::uint64_t> _next_register{ 0 };
+    std::atomic<std::uint64_t> _next_verify{ 0 };
+};
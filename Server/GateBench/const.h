@@ -0,0 +1,20 @@
+#pragma once
+#include <iostream>
+#include <boost/beast/http.hpp>
+#include <boost/beast.hpp>
+#include <boost/asio.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+
+namespace beast = boost::beast;         // from <boost/beast.hpp>
+namespace http = beast::http;           // from <boost/beast/http.hpp>
+namespace net = boost::asio;            // from <boost/asio.hpp>
+using tcp = boost::asio::ip::tcp;       // from <boost/asio/ip/tcp.hpp>
+
+using Clock = std::chrono::steady_clock;
+
+// GateServer֤rediskeyǰ׺GateServerconst.hһ
+#define CODEPREFIX "code_"
@@ -0,0 +1,222 @@
+#include "const.h"
+#include "BenchConfig.h"
+#include "BenchClient.h"
+#include "Workload.h"
+#include "AllocCheck.h"
+#include <cstdio>
+#include <fstream>
+#include <thread>
+
+namespace {
+    double Millis(std::uint64_t ns) {
+        return static_cast<double>(ns) / 1e6;
+    }
+
+    void PrintLatency(const char* name, const LatencyHistogram& histogram) {
+        std::printf("%-26s p50 %9.3f  p90 %9.3f  p99 %9.3f  p99.9 %9.3f  max %9.3f  mean %9.3f ms\n", name,
+            Millis(histogram.Percentile(0.5)), Millis(histogram.Percentile(0.9)),
+            Millis(histogram.Percentile(0.99)), Millis(histogram.Percentile(0.999)),
+            Millis(histogram.Max()), histogram.Mean() / 1e6);
+    }
+
+    void AppendLatencyJson(std::string& out, const char* name, const LatencyHistogram& histogram) {
+        char buf[256];
+        std::snprintf(buf, sizeof(buf),
+            "\"%s\":{\"p50\":%.3f,\"p90\":%.3f,\"p99\":%.3f,\"p999\":%.3f,\"max\":%.3f,\"mean\":%.3f}", name,
+            Millis(histogram.Percentile(0.5)), Millis(histogram.Percentile(0.9)),
+            Millis(histogram.Percentile(0.99)), Millis(histogram.Percentile(0.999)),
+            Millis(histogram.Max()), histogram.Mean() / 1e6);
+        out.append(buf);
+    }
+
+    // allocΪձʾûAllocBudget
+    void Report(const BenchConfig& cfg, const Workload& workload, const BenchStats& stats, const AllocResult* alloc) {
+        double seconds = static_cast<double>(cfg.duration.count());
+        std::uint64_t total = 0;
+        std::uint64_t http_errors = 0;
+        std::uint64_t app_errors = 0;
+        for (int i = 0; i < BenchStats::ROUTES; ++i) {
+            total += stats.requests[i];
+            http_errors += stats.http_errors[i];
+            app_errors += stats.app_errors[i];
+        }
+        bool corrected = cfg.open_loop || cfg.rate > 0;
+
+        std::printf("\nGateBench run %s: %s loop, %zu connections on %zu threads, keep-alive %s, %llds (+%llds warmup)\n",
+            workload.RunId().c_str(), cfg.open_loop ? "open" : "closed", cfg.connections, cfg.threads,
+            cfg.keep_alive ? "on" : "off",
+            static_cast<long long>(cfg.duration.count()), static_cast<long long>(cfg.warmup.count()));
+        if (cfg.open_loop) {
+            std::printf("target rate               %.0f req/s\n", cfg.rate);
+        }
+        std::printf("requests                  %llu (%.1f req/s), http errors %llu, app errors %llu, io errors %llu\n",
+            static_cast<unsigned long long>(total), static_cast<double>(total) / seconds,
+            static_cast<unsigned long long>(http_errors), static_cast<unsigned long long>(app_errors),
+            static_cast<unsigned long long>(stats.io_errors));
+        std::printf("connections               %llu opened (%.1f conn/s), connect errors %llu\n",
+            static_cast<unsigned long long>(stats.connects), static_cast<double>(stats.connects) / seconds,
+            static_cast<unsigned long long>(stats.connect_errors));
+        std::printf("transfer                  %.2f MB/s sent, %.2f MB/s received\n",
+            static_cast<double>(stats.bytes_sent) / seconds / 1e6, static_cast<double>(stats.bytes_received) / seconds / 1e6);
+        PrintLatency(corrected ? "latency (corrected)" : "latency (uncorrected)", stats.latency);
+        PrintLatency("service time", stats.service);
+        if (stats.connect.Count() > 0) {
+            PrintLatency("connect", stats.connect);
+        }
+        for (int i = 0; i < BenchStats::ROUTES; ++i) {
+            if (stats.requests[i] == 0) {
+                continue;
+            }
+            std::string name = std::string("  ") + RouteName(static_cast<BenchRoute>(i));
+            PrintLatency(name.c_str(), stats.route_latency[i]);
+            std::printf("  %-24s %llu requests, %llu http errors, %llu app errors\n", "",
+                static_cast<unsigned long long>(stats.requests[i]),
+                static_cast<unsigned long long>(stats.http_errors[i]),
+                static_cast<unsigned long long>(stats.app_errors[i]));
+        }
+        if (!corrected) {
+            std::printf("closed loop without Rate: latency is not corrected for coordinated omission\n");
+        }
+        if (alloc != nullptr) {
+            for (int i = 0; i < AllocResult::ROUTES; ++i) {
+                if (!alloc->measured[i]) {
+                    continue;
+                }
+                std::printf("allocations %-14s %.1f per request, %.0f bytes per request",
+                    RouteName(static_cast<BenchRoute>(i)), alloc->allocations[i], alloc->bytes[i]);
+                double budget = cfg.alloc_budget[i];
+                if (budget > 0) {
+                    std::printf(", budget %.1f%s", budget, alloc->allocations[i] > budget ? "  OVER BUDGET" : "");
+                }
+                std::printf("\n");
+            }
+        }
+
+        if (cfg.result_file.empty()) {
+            return;
+        }
+        // һѹһУڱȽϲͬ汾
+        std::string line = "{\"label\":\"" + cfg.label + "\",\"run\":\"" + workload.RunId() + "\"";
+        char buf[512];
+        std::snprintf(buf, sizeof(buf),
+            ",\"mode\":\"%s\",\"connections\":%zu,\"threads\":%zu,\"keep_alive\":%s,\"rate\":%.0f,\"duration\":%lld"
+            ",\"requests\":%llu,\"throughput\":%.1f,\"http_errors\":%llu,\"app_errors\":%llu,\"io_errors\":%llu"
+            ",\"connects_per_second\":%.1f,",
+            cfg.open_loop ? "open" : "closed", cfg.connections, cfg.threads, cfg.keep_alive ? "true" : "false",
+            cfg.rate, static_cast<long long>(cfg.duration.count()),
+            static_cast<unsigned long long>(total), static_cast<double>(total) / seconds,
+            static_cast<unsigned long long>(http_errors), static_cast<unsigned long long>(app_errors),
+            static_cast<unsigned long long>(stats.io_errors), static_cast<double>(stats.connects) / seconds);
+        line.append(buf);
+        AppendLatencyJson(line, "latency_ms", stats.latency);
+        line.push_back(',');
+        AppendLatencyJson(line, "service_ms", stats.service);
+        for (int i = 0; i < BenchStats::ROUTES; ++i) {
+            if (stats.requests[i] > 0) {
+                line.push_back(',');
+                AppendLatencyJson(line, RouteName(static_cast<BenchRoute>(i)), stats.route_latency[i]);
+            }
+        }
+        if (alloc != nullptr) {
+            line.append(",\"allocs_per_request\":{");
+            bool first = true;
+            for (int i = 0; i < AllocResult::ROUTES; ++i) {
+                if (!alloc->measured[i]) {
+                    continue;
+                }
+                std::snprintf(buf, sizeof(buf), "%s\"%s\":%.1f", first ? "" : ",",
+                    RouteName(static_cast<BenchRoute>(i)), alloc->allocations[i]);
+                line.append(buf);
+                first = false;
+            }
+            line.push_back('}');
+        }
+        line.append("}\n");
+        std::ofstream file(cfg.result_file, std::ios::app);
+        file << line;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        BenchConfig cfg = BenchConfig::Load(argc, argv);
+        Workload workload(cfg);
+
+        // עҪ֤дredis
+        auto seeded = workload.SeedRedis();
+        if (seeded > 0) {
+            std::cout << "seeded " << seeded << " verify codes into redis" << std::endl;
+        }
+
+        // AllocBudgetʱѹǰȡһGateServerķͳƣֵÿķ
+        AllocSnapshot alloc_before;
+        if (cfg.CheckAlloc()) {
+            alloc_before = AllocSnapshot::Fetch(cfg);
+            if (!alloc_before.enabled) {
+                throw std::runtime_error("AllocBudget needs GateServer built with GATE_ALLOC_PROFILE");
+            }
+        }
+
+        net::io_context resolver_ioc;
+        tcp::resolver resolver(resolver_ioc);
+        auto endpoints = resolver.resolve(cfg.host, cfg.port);
+
+        // ģʽƽָӣӵ״ηʱ
+        BenchSchedule schedule;
+        auto start = Clock::now() + std::chrono::milliseconds(100);
+        schedule.measure_start = start + cfg.warmup;
+        schedule.end = schedule.measure_start + cfg.duration;
+        std::chrono::duration<double> global_interval(0);
+        if (cfg.rate > 0) {
+            global_interval = std::chrono::duration<double>(1.0 / cfg.rate);
+            schedule.interval = std::chrono::duration_cast<Clock::duration>(global_interval * static_cast<double>(cfg.connections));
+        }
+
+        std::vector<std::unique_ptr<net::io_context>> contexts;
+        std::vector<std::unique_ptr<BenchStats>> stats;
+        for (std::size_t i = 0; i < cfg.threads; ++i) {
+            contexts.push_back(std::make_unique<net::io_context>(1));
+            stats.push_back(std::make_unique<BenchStats>());
+        }
+        for (std::size_t i = 0; i < cfg.connections; ++i) {
+            std::size_t index = i % cfg.threads;
+            auto first_send = start + std::chrono::duration_cast<Clock::duration>(global_interval * static_cast<double>(i));
+            std::make_shared<BenchClient>(*contexts[index], endpoints, cfg, workload, *stats[index], schedule,
+                first_send, 0x9E3779B97F4A7C15ull * (i + 1))->Start();
+        }
+
+        std::cout << "running " << (cfg.warmup + cfg.duration).count() << "s against "
+            << cfg.host << ":" << cfg.port << std::endl;
+        std::vector<std::thread> threads;
+        for (auto& ioc : contexts) {
+            threads.emplace_back([&ioc]() {
+                ioc->run();
+                });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+
+        BenchStats total;
+        for (auto& s : stats) {
+            total.Merge(*s);
+        }
+        if (!cfg.CheckAlloc()) {
+            Report(cfg, workload, total, nullptr);
+            return EXIT_SUCCESS;
+        }
+        auto alloc = AllocResult::Compare(cfg, alloc_before, AllocSnapshot::Fetch(cfg));
+        Report(cfg, workload, total, &alloc);
+        if (alloc.over_budget) {
+            std::cerr << "allocations per request over AllocBudget" << std::endl;
+            return 2;
+        }
+    }
+    catch (std::exception const& e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}
@@ -0,0 +1,48 @@
+#!/bin/bash
+# 短连接（KeepAlive=false）下accept吞吐随io线程数的变化
+# 对每个IOThreads分别用单acceptor和SO_REUSEPORT多acceptor各跑一次，后端全部使用进程内的假实现，
+# 结果追加到ResultFile（jsonl，Label为 reuseport-<on|off>-io<N>）
+#
+# 用法: accept_scaling.sh <GateServer可执行文件> <GateBench可执行文件> [额外的GateBench参数...]
+# 例如: accept_scaling.sh ./GateServer ./GateBench Duration=30 Connections=128
+#
+# 环境变量:
+#   IO_THREADS    要测试的io线程数，默认 "1 2 4 8"
+#   BENCH_THREADS GateBench的线程数，默认4
+#   RESULT_FILE   结果文件，默认 accept_scaling.jsonl
+set -e
+
+if [ $# -lt 2 ]; then
+    echo "usage: $0 <GateServer> <GateBench> [Key=Value ...]" >&2
+    exit 1
+fi
+GATE_SERVER=$(readlink -f "$1")
+GATE_BENCH=$(readlink -f "$2")
+shift 2
+
+SCRIPT_DIR=$(cd "$(dirname "$0")" && pwd)
+source "$SCRIPT_DIR/common.sh"
+SERVER_INI="$SCRIPT_DIR/../../GateServer/config.ini"
+BENCH_INI="$SCRIPT_DIR/../config.ini"
+IO_THREADS=${IO_THREADS:-"1 2 4 8"}
+BENCH_THREADS=${BENCH_THREADS:-4}
+RESULT_FILE=$(readlink -f "${RESULT_FILE:-accept_scaling.jsonl}")
+PORT=$(sed -n 's/^Port *= *//p' "$SERVER_INI" | head -1)
+
+WORK_DIR=$(mktemp -d)
+trap 'stop_server; rm -rf "$WORK_DIR"' EXIT
+
+# GateBench从当前目录读config.ini
+mkdir -p "$WORK_DIR/bench"
+cp "$BENCH_INI" "$WORK_DIR/bench/config.ini"
+
+for reuse in false true; do
+    for n in $IO_THREADS; do
+        start_server "s/^IOThreads *=.*/IOThreads = $n/" "s/^ReusePort *=.*/ReusePort = $reuse/"
+        label="reuseport-$([ $reuse = true ] && echo on || echo off)-io$n"
+        echo "== $label"
+        (cd "$WORK_DIR/bench" && "$GATE_BENCH" Port=$PORT KeepAlive=false Mix=get_test:1 \
+            Threads=$BENCH_THREADS Label=$label ResultFile="$RESULT_FILE" "$@") | grep -E "^(requests|connections|latency)"
+        stop_server
+    done
+done
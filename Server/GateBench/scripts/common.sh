@@ -0,0 +1,36 @@
+# 测试脚本共用的函数，用source引入
+# 调用方需要设置GATE_SERVER、SERVER_INI和WORK_DIR，GateServer在$WORK_DIR/server下以生成的config.ini启动
+
+SERVER_PID=
+
+# start_server sed表达式... ：以SERVER_INI为基础，后端全部换成进程内的假实现，再应用调用方的sed表达式
+start_server() {
+    local args=(-e "s/^Redis *= *false/Redis = true/"
+        -e "s/^Mysql *= *false/Mysql = true/"
+        -e "s/^Verify *= *false/Verify = true/")
+    for expr in "$@"; do
+        args+=(-e "$expr")
+    done
+    mkdir -p "$WORK_DIR/server"
+    sed "${args[@]}" "$SERVER_INI" > "$WORK_DIR/server/config.ini"
+    (cd "$WORK_DIR/server" && exec "$GATE_SERVER" > server.log 2>&1) &
+    SERVER_PID=$!
+    # 等待端口可以连接
+    local port
+    port=$(sed -n 's/^Port *= *//p' "$WORK_DIR/server/config.ini" | head -1)
+    for _ in $(seq 50); do
+        (exec 3<>/dev/tcp/127.0.0.1/$port) 2>/dev/null && return 0
+        sleep 0.1
+    done
+    echo "GateServer did not start, see $WORK_DIR/server/server.log" >&2
+    return 1
+}
+
+# 发SIGINT让GateServer正常退出（写出剩余日志和span）
+stop_server() {
+    if [ -n "$SERVER_PID" ]; then
+        kill -INT $SERVER_PID 2>/dev/null || true
+        wait $SERVER_PID 2>/dev/null || true
+        SERVER_PID=
+    fi
+}
@@ -0,0 +1,54 @@
+#!/bin/bash
+# 协程handler和阻塞handler（[GateServer] HandlerMode = blocking）在不同后端延迟下的对比
+# 假Redis、MySQL和VerifyServer使用同样的注入延迟，请求只包含访问后端的get_verifycode和user_register，
+# 用开环模式以固定速率发送，两种handler承受同样的负载；结果追加到ResultFile（jsonl，Label为 <coroutine|blocking>-<延迟>ms）
+# 注意user_register的验证码要提前逐条写进有延迟的假Redis，速率和时长越大准备时间越长
+#
+# 用法: handler_ab.sh <GateServer可执行文件> <GateBench可执行文件> [额外的GateBench参数...]
+# 例如: handler_ab.sh ./GateServer ./GateBench Duration=30 Connections=128
+#
+# 环境变量:
+#   LATENCIES     注入的后端延迟，单位毫秒，默认 "0 2 10"
+#   RATE          每秒请求数，默认500
+#   IO_THREADS    GateServer的io线程数，默认2
+#   BENCH_THREADS GateBench的线程数，默认4
+#   RESULT_FILE   结果文件，默认 handler_ab.jsonl
+set -e
+
+if [ $# -lt 2 ]; then
+    echo "usage: $0 <GateServer> <GateBench> [Key=Value ...]" >&2
+    exit 1
+fi
+GATE_SERVER=$(readlink -f "$1")
+GATE_BENCH=$(readlink -f "$2")
+shift 2
+
+SCRIPT_DIR=$(cd "$(dirname "$0")" && pwd)
+source "$SCRIPT_DIR/common.sh"
+SERVER_INI="$SCRIPT_DIR/../../GateServer/config.ini"
+BENCH_INI="$SCRIPT_DIR/../config.ini"
+LATENCIES=${LATENCIES:-"0 2 10"}
+RATE=${RATE:-500}
+IO_THREADS=${IO_THREADS:-2}
+BENCH_THREADS=${BENCH_THREADS:-4}
+RESULT_FILE=$(readlink -f "${RESULT_FILE:-handler_ab.jsonl}")
+PORT=$(sed -n 's/^Port *= *//p' "$SERVER_INI" | head -1)
+
+WORK_DIR=$(mktemp -d)
+trap 'stop_server; rm -rf "$WORK_DIR"' EXIT
+
+# GateBench从当前目录读config.ini，user_register需要的验证码由GateBench预先写进假Redis
+mkdir -p "$WORK_DIR/bench"
+cp "$BENCH_INI" "$WORK_DIR/bench/config.ini"
+
+for latency in $LATENCIES; do
+    for mode in coroutine blocking; do
+        start_server "s/^IOThreads *=.*/IOThreads = $IO_THREADS/" "s/^HandlerMode *=.*/HandlerMode = $mode/" \
+            "s/^\(Redis\|Mysql\|Verify\)Latency *=.*/\1Latency = $latency/"
+        label="$mode-${latency}ms"
+        echo "== $label"
+        (cd "$WORK_DIR/bench" && "$GATE_BENCH" Port=$PORT Mode=open Rate=$RATE Mix=get_verifycode:1,user_register:1 \
+            Threads=$BENCH_THREADS Label=$label ResultFile="$RESULT_FILE" "$@") | grep -E "^(requests|latency|  )"
+        stop_server
+    done
+done
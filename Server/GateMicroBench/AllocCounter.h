@@ -0,0 +1,26 @@
+#pragma once
+#include <benchmark/benchmark.h>
+#include "AllocProfile.h"
+
+// GATE_ALLOC_PROFILEʱͳƴӹ쵽֮䵱ǰ̵߳Ķѷ䣬
+// ʱƽΪallocsalloc_bytesУδʱ
+class AllocCounter
+{
+public:
+    explicit AllocCounter(benchmark::State& state) : _state(state), _scope(&_tally) {}
+    ~AllocCounter() {
+        if constexpr (AllocProfile::Enabled()) {
+            _state.counters["allocs"] = benchmark::Counter(
+                static_cast<double>(_tally.allocations.load()), benchmark::Counter::kAvgIterations);
+            _state.counters["alloc_bytes"] = benchmark::Counter(
+                static_cast<double>(_tally.bytes.load()), benchmark::Counter::kAvgIterations);
+        }
+    }
+    AllocCounter(const AllocCounter&) = delete;
+    AllocCounter& operator=(const AllocCounter&) = delete;
+
+private:
+    benchmark::State& _state;
+    AllocProfile::Tally _tally;
+    AllocProfile::Scope _scope;
+};
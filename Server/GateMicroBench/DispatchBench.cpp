@@ -0,0 +1,131 @@
+#include <benchmark/benchmark.h>
+#include "MicroBenchAccess.h"
+#include "LogicSystem.h"
+#include "Router.h"
+#include "AsioIOContextPool.h"
+#include "HttpConnectionPool.h"
+#include "AllocCounter.h"
+#include <future>
+#include <map>
+
+namespace {
+    // LogicSystemע·һ£ټrange(0)鹲"/api/item"ǰ׺·ģ·ɱ
+    // ÿһ̬·/api/item<i>һ·/api/item<i>/{id}/detail
+    const Router& BenchRouter(std::size_t routes) {
+        static std::map<std::size_t, std::unique_ptr<Router>> routers;
+        auto& router = routers[routes];
+        if (!router) {
+            router = std::make_unique<Router>();
+            router->Add(http::verb::get, "/get_test", 0);
+            router->Add(http::verb::get, "/metrics", 1);
+            router->Add(http::verb::post, "/get_verifycode", 2);
+            router->Add(http::verb::post, "/user_register", 3);
+            router->Add(http::verb::get, "/user/{uid}", 4);
+            router->Add(http::verb::get, "/user/{uid}/friends", 5);
+            router->Add(http::verb::post, "/user/{uid}/reset_pwd", 6);
+            for (std::size_t i = 0; i < routes; ++i) {
+                std::string item = "/api/item" + std::to_string(i);
+                router->Add(http::verb::get, item, 7 + 2 * i);
+                router->Add(http::verb::get, item + "/{id}/detail", 8 + 2 * i);
+            }
+        }
+        return *router;
+    }
+
+    // ƥ·ɱмһ飬·ɹ"/api/item"ǰ׺ʱӦ·
+    void BM_Router_MatchStatic(benchmark::State& state) {
+        std::size_t routes = static_cast<std::size_t>(state.range(0));
+        const auto& router = BenchRouter(routes);
+        std::string path = "/api/item" + std::to_string(routes / 2);
+        PathParams params;
+        std::size_t handler_id = 0;
+        unsigned allowed = 0;
+        for (auto _ : state) {
+            params.clear();
+            benchmark::DoNotOptimize(router.Match(http::verb::get, path, handler_id, params, allowed));
+        }
+    }
+    BENCHMARK(BM_Router_MatchStatic)->RangeMultiplier(8)->Range(8, 4096);
+
+    void BM_Router_MatchParam(benchmark::State& state) {
+        std::size_t routes = static_cast<std::size_t>(state.range(0));
+        const auto& router = BenchRouter(routes);
+        std::string path = "/api/item" + std::to_string(routes / 2) + "/10086/detail";
+        PathParams params;
+        std::size_t handler_id = 0;
+        unsigned allowed = 0;
+        for (auto _ : state) {
+            params.clear();
+            benchmark::DoNotOptimize(router.Match(http::verb::get, path, handler_id, params, allowed));
+        }
+    }
+    BENCHMARK(BM_Router_MatchParam)->RangeMultiplier(8)->Range(8, 4096);
+
+    // ǰ׺ûжӦ·
+    void BM_Router_NotFound(benchmark::State& state) {
+        const auto& router = BenchRouter(static_cast<std::size_t>(state.range(0)));
+        PathParams params;
+        std::size_t handler_id = 0;
+        unsigned allowed = 0;
+        for (auto _ : state) {
+            params.clear();
+            benchmark::DoNotOptimize(router.Match(http::verb::get, "/api/itemx", handler_id, params, allowed));
+        }
+    }
+    BENCHMARK(BM_Router_NotFound)->RangeMultiplier(8)->Range(8, 4096);
+
+    // LogicSystem::Dispatch/get_testͬ·ƥ䡢ָǩʹ
+    void BM_LogicSystem_DispatchGetTest(benchmark::State& state) {
+        auto& ioc = AsioIOContextPool::GetInstance()->GetIOContext(0);
+        auto con = std::make_shared<HttpConnection>(ioc, AsioIOContextPool::GetInstance()->GetTimerWheel(ioc));
+        std::string target = "/get_test?key1=value1&key2=value2";
+        MicroBenchAccess::SetRequest(*con, http::verb::get, target);
+        MicroBenchAccess::PreParseGetParam(*con);
+        auto* logic = LogicSystem::GetInstance().get();
+        AllocCounter allocs(state);
+        for (auto _ : state) {
+            MicroBenchAccess::ResponseBody(*con).clear();
+            benchmark::DoNotOptimize(logic->Dispatch(http::verb::get, "/get_test", con));
+        }
+    }
+    BENCHMARK(BM_LogicSystem_DispatchGetTest);
+
+    void BM_LogicSystem_DispatchNotFound(benchmark::State& state) {
+        auto& ioc = AsioIOContextPool::GetInstance()->GetIOContext(0);
+        auto con = std::make_shared<HttpConnection>(ioc, AsioIOContextPool::GetInstance()->GetTimerWheel(ioc));
+        auto* logic = LogicSystem::GetInstance().get();
+        AllocCounter allocs(state);
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(logic->Dispatch(http::verb::get, "/favicon.ico", con));
+        }
+    }
+    BENCHMARK(BM_LogicSystem_DispatchNotFound);
+
+    // õĲȡio_contextCServerÿһӵһΣReusePortرʱacceptorͬʱ
+    void BM_AsioIOContextPool_GetIOContext(benchmark::State& state) {
+        auto pool = AsioIOContextPool::GetInstance();
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(&pool->GetIOContext());
+        }
+    }
+    BENCHMARK(BM_AsioIOContextPool_GetIOContext)->ThreadRange(1, 8)->UseRealTime();
+
+    // ӶȡһӲͷʱŻأÿacceptʱmake_shared
+    // ڳioִ߳У黹ʱֱӷŻؿ߳Ͷ
+    void BM_HttpConnectionPool_AcquireRelease(benchmark::State& state) {
+        auto pool = AsioIOContextPool::GetInstance();
+        auto& ioc = pool->GetIOContext(0);
+        auto& connections = pool->GetConnectionPool(ioc);
+        std::promise<void> done;
+        net::post(ioc, [&state, &connections, &done]() {
+            AllocCounter allocs(state);
+            for (auto _ : state) {
+                auto con = connections.Acquire();
+                benchmark::DoNotOptimize(con.get());
+            }
+            done.set_value();
+            });
+        done.get_future().wait();
+    }
+    BENCHMARK(BM_HttpConnectionPool_AcquireRelease)->UseRealTime();
+}
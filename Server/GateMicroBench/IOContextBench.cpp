@@ -0,0 +1,87 @@
+#include <benchmark/benchmark.h>
+#include "IOContextSelector.h"
+#include <algorithm>
+#include <deque>
+
+namespace {
+    constexpr std::size_t CONTEXTS = 8;
+
+    IOContextPolicy PolicyArg(const benchmark::State& state) {
+        return static_cast<IOContextPolicy>(state.range(0));
+    }
+
+    // ԵѡĿ߳ͬʱѡʱѯں֮ش
+    void BM_IOContextSelector_Select(benchmark::State& state) {
+        static IOContextSelector* selectors[] = {
+            new IOContextSelector(CONTEXTS, IOContextPolicy::RoundRobin),
+            new IOContextSelector(CONTEXTS, IOContextPolicy::LeastConn),
+            new IOContextSelector(CONTEXTS, IOContextPolicy::PowerOfTwo),
+        };
+        auto& selector = *selectors[state.range(0)];
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(selector.Select());
+        }
+        state.SetLabel(IOContextSelector::PolicyName(selector.Policy()));
+    }
+    BENCHMARK(BM_IOContextSelector_Select)->DenseRange(0, 2)->ThreadRange(1, 8)->UseRealTime();
+
+    // б¸Եľ̶ȣÿεһӣѡio_context
+    // ÿʮһǳʱ䱣ܼ֡ӣ;20400εǶӣ140ε
+    // ںio_contextʣѯӶŵһio_contextϡ
+    // ƽ ;/ƽ;imbalanceͬھconn_imbalance1Ϊȫ
+    void BM_IOContextSelector_Skewed(benchmark::State& state) {
+        IOContextSelector selector(CONTEXTS, PolicyArg(state));
+        struct Conn {
+            std::size_t index;
+            std::int64_t requests;
+            std::uint64_t expire;
+        };
+        std::deque<Conn> heavy;
+        std::deque<Conn> light;
+        std::uint64_t tick = 0;
+        double imbalance = 0;
+        double conn_imbalance = 0;
+        std::uint64_t samples = 0;
+        auto expire = [&selector](std::deque<Conn>& conns, std::uint64_t now) {
+            while (!conns.empty() && conns.front().expire <= now) {
+                auto& load = selector.Load(conns.front().index);
+                load.connections.fetch_sub(1, std::memory_order_relaxed);
+                load.requests.fetch_sub(conns.front().requests, std::memory_order_relaxed);
+                conns.pop_front();
+            }
+        };
+        for (auto _ : state) {
+            ++tick;
+            expire(heavy, tick);
+            expire(light, tick);
+            bool is_heavy = tick % 10 == 0;
+            Conn conn{ selector.Select(), is_heavy ? 20 : 1, tick + (is_heavy ? 400 : 40) };
+            auto& load = selector.Load(conn.index);
+            load.connections.fetch_add(1, std::memory_order_relaxed);
+            load.requests.fetch_add(conn.requests, std::memory_order_relaxed);
+            (is_heavy ? heavy : light).push_back(conn);
+
+            // Ԥȵ̬֮ʼ
+            if (tick > 400) {
+                std::int64_t max_requests = 0, total_requests = 0, max_connections = 0, total_connections = 0;
+                for (std::size_t i = 0; i < CONTEXTS; ++i) {
+                    auto requests = selector.Load(i).requests.load(std::memory_order_relaxed);
+                    auto connections = selector.Load(i).connections.load(std::memory_order_relaxed);
+                    max_requests = std::max(max_requests, requests);
+                    total_requests += requests;
+                    max_connections = std::max(max_connections, connections);
+                    total_connections += connections;
+                }
+                imbalance += static_cast<double>(max_requests) * CONTEXTS / static_cast<double>(total_requests);
+                conn_imbalance += static_cast<double>(max_connections) * CONTEXTS / static_cast<double>(total_connections);
+                ++samples;
+            }
+        }
+        if (samples > 0) {
+            state.counters["imbalance"] = imbalance / static_cast<double>(samples);
+            state.counters["conn_imbalance"] = conn_imbalance / static_cast<double>(samples);
+        }
+        state.SetLabel(IOContextSelector::PolicyName(selector.Policy()));
+    }
+    BENCHMARK(BM_IOContextSelector_Skewed)->DenseRange(0, 2)->Iterations(200000);
+}
@@ -0,0 +1,97 @@
+#include <benchmark/benchmark.h>
+#include "JsonBody.h"
+#include "JsonWriter.h"
+#include "const.h"
+#include "AllocCounter.h"
+
+namespace {
+    // Ϳͻע淢͵һ£range(0)Ϊӵֽ
+    std::string RegisterBody(std::size_t padding) {
+        std::string body = "{\"email\":\"bench_user_1@example.com\",\"user\":\"bench_user_1\","
+            "\"passwd\":\"745230\",\"confirm\":\"745230\",\"verifycode\":\"a1b2c3\"";
+        if (padding > 0) {
+            body.append(",\"pad\":\"").append(padding, 'x').append("\"");
+        }
+        body.append("}");
+        return body;
+    }
+
+    void BM_JsonBody_ParseRegister(benchmark::State& state) {
+        std::string body = RegisterBody(static_cast<std::size_t>(state.range(0)));
+        AllocCounter allocs(state);
+        for (auto _ : state) {
+            JsonBody root;
+            benchmark::DoNotOptimize(root.Parse(body));
+            benchmark::DoNotOptimize(root.Get("email"));
+            benchmark::DoNotOptimize(root.Get("verifycode"));
+        }
+        state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * body.size()));
+        state.SetLabel(JsonBody::Backend());
+    }
+    BENCHMARK(BM_JsonBody_ParseRegister)->Arg(0)->Arg(1024)->Arg(16 * 1024);
+
+    // JsonBody֮ǰĽʽΪ
+    void BM_JsonCpp_ParseRegister(benchmark::State& state) {
+        std::string body = RegisterBody(static_cast<std::size_t>(state.range(0)));
+        AllocCounter allocs(state);
+        for (auto _ : state) {
+            Json::Reader reader;
+            Json::Value root;
+            benchmark::DoNotOptimize(reader.parse(body, root));
+            benchmark::DoNotOptimize(root["email"].asString());
+            benchmark::DoNotOptimize(root["verifycode"].asString());
+        }
+        state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * body.size()));
+    }
+    BENCHMARK(BM_JsonCpp_ParseRegister)->Arg(0)->Arg(1024)->Arg(16 * 1024);
+
+    // /user_registerɹʱӦд븴õbody
+    void BM_JsonWriter_RegisterReply(benchmark::State& state) {
+        std::string body;
+        std::string email = "bench_user_1@example.com";
+        std::string name = "bench_user_1";
+        AllocCounter allocs(state);
+        for (auto _ : state) {
+            body.clear();
+            JsonWriter(body).BeginObject()
+                .Field("error", 0)
+                .Field("uid", 10086)
+                .Field("email", email)
+                .Field("user", name)
+                .Field("passwd", "745230")
+                .Field("confirm", "745230")
+                .Field("verifycode", "a1b2c3")
+                .EndObject();
+            benchmark::DoNotOptimize(body.data());
+        }
+    }
+    BENCHMARK(BM_JsonWriter_RegisterReply);
+
+    // JsonWriter֮ǰдΪ
+    void BM_JsonCpp_RegisterReply(benchmark::State& state) {
+        std::string email = "bench_user_1@example.com";
+        std::string name = "bench_user_1";
+        AllocCounter allocs(state);
+        for (auto _ : state) {
+            Json::Value root;
+            root["error"] = 0;
+            root["uid"] = 10086;
+            root["email"] = email;
+            root["user"] = name;
+            root["passwd"] = "745230";
+            root["confirm"] = "745230";
+            root["verifycode"] = "a1b2c3";
+            benchmark::DoNotOptimize(root.toStyledString());
+        }
+    }
+    BENCHMARK(BM_JsonCpp_RegisterReply);
+
+    void BM_JsonTemplates_Error(benchmark::State& state) {
+        std::string body;
+        for (auto _ : state) {
+            body = JsonTemplates::Error(1005);
+            benchmark::DoNotOptimize(body.data());
+        }
+    }
+    BENCHMARK(BM_JsonTemplates_Error);
+}
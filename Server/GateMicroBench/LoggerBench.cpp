@@ -0,0 +1,63 @@
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <cstdio>
+#include <fcntl.h>
+#include <iostream>
+#include <thread>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+#include "Logger.h"
+#include "AllocCounter.h"
+
+// 첽־ԭstd::cout << std::endlдĶԱȣ߶stdout
+// ڼstdoutض򵽿豸ֻȽϵ÷̵߳ĿͶ߳µ
+namespace {
+#ifdef _WIN32
+    const char* NULL_DEVICE = "NUL";
+#else
+    const char* NULL_DEVICE = "/dev/null";
+#endif
+    int saved_stdout = -1;
+
+    void StdoutToNull(const benchmark::State&) {
+        std::cout.flush();
+        std::fflush(stdout);
+        saved_stdout = dup(1);
+        int null_fd = open(NULL_DEVICE, O_WRONLY);
+        dup2(null_fd, 1);
+        close(null_fd);
+    }
+
+    void RestoreStdout(const benchmark::State&) {
+        // ̨߳ÿ10ˢһΣһֵ־дٻָ
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        std::cout.flush();
+        std::fflush(stdout);
+        dup2(saved_stdout, 1);
+        close(saved_stdout);
+    }
+
+    // /get_verifycodeе־һһַһ
+    void BM_Logger_Info(benchmark::State& state) {
+        std::string email = "bench_user_1@example.com";
+        std::int64_t i = 0;
+        AllocCounter allocs(state);
+        for (auto _ : state) {
+            LOG_INFO("email is ", email, " seq ", ++i);
+        }
+    }
+    BENCHMARK(BM_Logger_Info)->ThreadRange(1, 16)->UseRealTime()->Setup(StdoutToNull)->Teardown(RestoreStdout);
+
+    void BM_Cout_Endl(benchmark::State& state) {
+        std::string email = "bench_user_1@example.com";
+        std::int64_t i = 0;
+        AllocCounter allocs(state);
+        for (auto _ : state) {
+            std::cout << "email is " << email << " seq " << ++i << std::endl;
+        }
+    }
+    BENCHMARK(BM_Cout_Endl)->ThreadRange(1, 16)->UseRealTime()->Setup(StdoutToNull)->Teardown(RestoreStdout);
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include "HttpConnection.h"
+
+// ΢׼ԷHttpConnection˽гԱsocketֱѯ·ɷַ
+struct MicroBenchAccess {
+    static void SetRequest(HttpConnection& con, http::verb method, std::string_view target) {
+        con._request.method(method);
+        con._request.target(target);
+    }
+
+    static bool PreParseGetParam(HttpConnection& con) {
+        return con.PreParseGetParam();
+    }
+
+    static QueryParams& GetParams(HttpConnection& con) {
+        return con._get_params;
+    }
+
+    static void Reset(HttpConnection& con) {
+        con.ResetForNextRequest();
+    }
+
+    static std::string& ResponseBody(HttpConnection& con) {
+        return con._response.body();
+    }
+};
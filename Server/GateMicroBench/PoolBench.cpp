@@ -0,0 +1,184 @@
+#include <benchmark/benchmark.h>
+#include "RedisMgr.h"
+#include "MysqlDao.h"
+#include "VerifyGrpcClient.h"
+#include <algorithm>
+#include <array>
+#include <thread>
+
+// ӳȡӵĿͶ߳̾شСGateServerһΪ5
+// ߳شСʱȴӵʱ䣻VerifyGrpcClientûӳأ첽õ
+namespace {
+    constexpr std::size_t POOL_SIZE = 5;
+
+    // ػػϵСredisӦˣÿظ+OKֻRedisConPoolӲͨAUTH
+    // ַвܺ'*'
+    class OkRespServer {
+    public:
+        OkRespServer()
+            : _acceptor(_ioc, tcp::endpoint(net::ip::make_address("127.0.0.1"), 0)) {
+            Accept();
+            std::thread([this]() { _ioc.run(); }).detach();
+        }
+
+        int Port() const {
+            return _acceptor.local_endpoint().port();
+        }
+
+    private:
+        using Buffer = std::array<char, 4096>;
+
+        void Accept() {
+            _acceptor.async_accept([this](boost::system::error_code ec, tcp::socket socket) {
+                if (!ec) {
+                    Read(std::make_shared<tcp::socket>(std::move(socket)), std::make_shared<Buffer>());
+                }
+                Accept();
+                });
+        }
+
+        static void Read(std::shared_ptr<tcp::socket> socket, std::shared_ptr<Buffer> buffer) {
+            socket->async_read_some(net::buffer(*buffer), [socket, buffer](boost::system::error_code ec, std::size_t n) {
+                if (ec) {
+                    return;
+                }
+                auto commands = std::count(buffer->begin(), buffer->begin() + n, '*');
+                std::string reply;
+                for (std::ptrdiff_t i = 0; i < commands; ++i) {
+                    reply.append("+OK\r\n");
+                }
+                boost::system::error_code write_ec;
+                net::write(*socket, net::buffer(reply), write_ec);
+                if (!write_ec) {
+                    Read(socket, buffer);
+                }
+                });
+        }
+
+        net::io_context _ioc;
+        tcp::acceptor _acceptor;
+    };
+
+    RedisConPool& BenchRedisPool() {
+        static RedisConPool* pool = []() {
+            static OkRespServer* server = new OkRespServer();
+            return new RedisConPool(POOL_SIZE, "127.0.0.1", server->Port(), "bench");
+        }();
+        return *pool;
+    }
+
+    // ûлỰӣֻӳر
+    MySqlPool& BenchMysqlPool() {
+        static MySqlPool* pool = []() {
+            std::vector<std::unique_ptr<SqlConnection>> connections;
+            for (std::size_t i = 0; i < POOL_SIZE; ++i) {
+                connections.push_back(std::make_unique<SqlConnection>(nullptr, 0));
+            }
+            return new MySqlPool(std::move(connections));
+        }();
+        return *pool;
+    }
+
+    // ػػϵСVerifyServiceredisֱӻظ̶֤룬
+    // Ŀ¼config.ini[VarifyServer]ĵַVerifyGrpcClient
+    class EchoVerifyService final : public VerifyService::Service {
+    public:
+        EchoVerifyService() {
+            auto& cfg = ConfigMgr::Inst();
+            grpc::ServerBuilder builder;
+            builder.AddListeningPort(cfg["VarifyServer"]["Host"] + ":" + cfg["VarifyServer"]["Port"],
+                grpc::InsecureServerCredentials());
+            builder.RegisterService(this);
+            _server = builder.BuildAndStart();
+        }
+
+        bool Running() const {
+            return _server != nullptr;
+        }
+
+    private:
+        Status GetVerifyCode(grpc::ServerContext* context, const GetVerifyReq* request,
+            GetVerifyRsp* reply) override {
+            reply->set_error(ErrorCodes::Success);
+            reply->set_email(request->email());
+            reply->set_code("0000");
+            return Status::OK;
+        }
+
+        std::unique_ptr<grpc::Server> _server;
+    };
+
+    EchoVerifyService& BenchVerifyService() {
+        static EchoVerifyService* service = new EchoVerifyService();
+        return *service;
+    }
+
+    void BM_RedisConPool_GetReturn(benchmark::State& state) {
+        auto& pool = BenchRedisPool();
+        for (auto _ : state) {
+            auto* context = pool.getConnection();
+            if (context == nullptr) {
+                state.SkipWithError("redis pool has no connection");
+                break;
+            }
+            benchmark::DoNotOptimize(context);
+            pool.returnConnection(context);
+        }
+    }
+    BENCHMARK(BM_RedisConPool_GetReturn)->ThreadRange(1, 16)->UseRealTime();
+
+    void BM_MySqlPool_GetReturn(benchmark::State& state) {
+        auto& pool = BenchMysqlPool();
+        for (auto _ : state) {
+            auto con = pool.getConnection();
+            benchmark::DoNotOptimize(con.get());
+            pool.returnConnection(std::move(con));
+        }
+    }
+    BENCHMARK(BM_MySqlPool_GetReturn)->ThreadRange(1, 16)->UseRealTime();
+
+    // ѡstubֻһԭԱӳصȡͨڵһεʱӣҪVerifyServer
+    void BM_GrpcChannelSet_Next(benchmark::State& state) {
+        static GrpcChannelSet<VerifyService>* channels = []() {
+            GrpcChannelOptions options;
+            options.target = "127.0.0.1:50051";
+            options.channels = POOL_SIZE;
+            return new GrpcChannelSet<VerifyService>(options);
+        }();
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(&channels->Next());
+        }
+    }
+    BENCHMARK(BM_GrpcChannelSet_Next)->ThreadRange(1, 16)->UseRealTime();
+
+    // VerifyGrpcClientٽstubһ첽õcq߳ȡ¼Ͷݻio_contextָЭ
+    // ͬʱ;ĵһio߳Ϸ𣬳POOL_SIZEҲҪŶӵstub
+    void BM_VerifyGrpcClient_AsyncCall(benchmark::State& state) {
+        if (!BenchVerifyService().Running()) {
+            state.SkipWithError("verify service failed to listen");
+            return;
+        }
+        auto client = VerifyGrpcClient::GetInstance();
+        const auto concurrency = state.range(0);
+        net::io_context ioc;
+        for (auto _ : state) {
+            std::int64_t failed = 0;
+            for (std::int64_t i = 0; i < concurrency; ++i) {
+                net::co_spawn(ioc, [&client, &failed]() -> net::awaitable<void> {
+                    GetVerifyRsp rsp = co_await client->AsyncGetvarifyCode("bench@example.com");
+                    if (rsp.error() != ErrorCodes::Success) {
+                        ++failed;
+                    }
+                    }, net::detached);
+            }
+            ioc.run();
+            ioc.restart();
+            if (failed > 0) {
+                state.SkipWithError("verify call failed");
+                break;
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * concurrency);
+    }
+    BENCHMARK(BM_VerifyGrpcClient_AsyncCall)->Arg(1)->Arg(POOL_SIZE)->Arg(64)->UseRealTime();
+}
@@ -0,0 +1,76 @@
+#include <benchmark/benchmark.h>
+#include "QueryString.h"
+#include "MicroBenchAccess.h"
+#include "AsioIOContextPool.h"
+
+namespace {
+    const std::string PLAIN = "user_name_12345";
+    const std::string ENCODED_SOURCE = "zhang san test@example.com/a+b=c&d";
+
+    void BM_UrlEncode_Plain(benchmark::State& state) {
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(UrlEncode(PLAIN));
+        }
+    }
+    BENCHMARK(BM_UrlEncode_Plain);
+
+    void BM_UrlEncode_Escaped(benchmark::State& state) {
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(UrlEncode(ENCODED_SOURCE));
+        }
+    }
+    BENCHMARK(BM_UrlEncode_Escaped);
+
+    void BM_UrlDecode_Escaped(benchmark::State& state) {
+        std::string encoded = UrlEncode(ENCODED_SOURCE);
+        std::string out;
+        for (auto _ : state) {
+            out.clear();
+            benchmark::DoNotOptimize(UrlDecode(encoded, out));
+        }
+    }
+    BENCHMARK(BM_UrlDecode_Escaped);
+
+    // ѯΪrange(0)תĲΪrange(1)%
+    std::string MakeTarget(int params, int escaped_percent) {
+        std::string target = "/get_test";
+        for (int i = 0; i < params; ++i) {
+            target.append(i == 0 ? "?" : "&");
+            target.append("key").append(std::to_string(i)).append("=");
+            if (i * 100 < params * escaped_percent) {
+                target.append(UrlEncode("value " + std::to_string(i) + "@x"));
+            }
+            else {
+                target.append("value").append(std::to_string(i));
+            }
+        }
+        return target;
+    }
+
+    void BM_QueryParams_Parse(benchmark::State& state) {
+        std::string target = MakeTarget(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+        std::string_view query(target);
+        query = query.substr(query.find('?') + 1);
+        QueryParams params;
+        for (auto _ : state) {
+            params.Clear();
+            benchmark::DoNotOptimize(params.Parse(query));
+        }
+    }
+    BENCHMARK(BM_QueryParams_Parse)->Args({ 2, 0 })->Args({ 8, 0 })->Args({ 8, 50 })->Args({ 32, 50 });
+
+    // HttpConnection::PreParseGetParam'?'һεĲkeyȡһνֵ
+    void BM_PreParseGetParam(benchmark::State& state) {
+        std::string target = MakeTarget(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+        auto& ioc = AsioIOContextPool::GetInstance()->GetIOContext(0);
+        auto con = std::make_shared<HttpConnection>(ioc, AsioIOContextPool::GetInstance()->GetTimerWheel(ioc));
+        MicroBenchAccess::SetRequest(*con, http::verb::get, target);
+        for (auto _ : state) {
+            MicroBenchAccess::GetParams(*con).Clear();
+            benchmark::DoNotOptimize(MicroBenchAccess::PreParseGetParam(*con));
+            std::string value;
+            benchmark::DoNotOptimize(MicroBenchAccess::GetParams(*con).Get("key1", value));
+        }
+    }
+    BENCHMARK(BM_PreParseGetParam)->Args({ 2, 0 })->Args({ 8, 50 });
+}
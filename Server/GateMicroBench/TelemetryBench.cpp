@@ -0,0 +1,60 @@
+#include <benchmark/benchmark.h>
+#include "Metrics.h"
+#include "Tracer.h"
+
+// ·ÿζִеָ·׷ٿ
+namespace {
+    void BM_Counter_Inc(benchmark::State& state) {
+        static Counter& counter = Metrics::Inst().GetCounter("bench_counter_total", "microbenchmark counter");
+        for (auto _ : state) {
+            counter.Inc();
+        }
+    }
+    BENCHMARK(BM_Counter_Inc)->ThreadRange(1, 16)->UseRealTime();
+
+    void BM_Histogram_RecordDuration(benchmark::State& state) {
+        static Histogram& histogram = Metrics::Inst().GetHistogram("bench_duration_seconds", "microbenchmark histogram");
+        std::chrono::microseconds value(1);
+        for (auto _ : state) {
+            histogram.RecordDuration(value);
+            value = std::chrono::microseconds((value.count() * 7 + 13) % 100000);
+        }
+    }
+    BENCHMARK(BM_Histogram_RecordDuration)->ThreadRange(1, 16)->UseRealTime();
+
+    // /metricsץȡһεĿrange(0)Ϊֱͼ
+    void BM_Metrics_Render(benchmark::State& state) {
+        for (int i = 0; i < state.range(0); ++i) {
+            Metrics::Inst().GetHistogram("bench_render_seconds", "microbenchmark render",
+                "route=\"/bench/" + std::to_string(i) + "\"").Record(static_cast<std::uint64_t>(i));
+        }
+        std::string out;
+        for (auto _ : state) {
+            out.clear();
+            Metrics::Inst().Render(out);
+            benchmark::DoNotOptimize(out.data());
+        }
+    }
+    BENCHMARK(BM_Metrics_Render)->Arg(8)->Arg(64);
+
+    // δһspanspanӦڴ
+    void BM_Tracer_UnsampledRequest(benchmark::State& state) {
+        for (auto _ : state) {
+            Span request = Tracer::Inst().StartRequest("", "GET /get_test");
+            Span redis(request.Context(), "redis GET", SpanKind::Client);
+            Span mysql(request.Context(), "mysql RegUserTransaction", SpanKind::Client);
+            Span write(request.Context(), "write response");
+            benchmark::DoNotOptimize(write.Recording());
+        }
+    }
+    BENCHMARK(BM_Tracer_UnsampledRequest);
+
+    void BM_TraceContext_Parse(benchmark::State& state) {
+        TraceContext context;
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(TraceContext::FromTraceParent(
+                "00-0af7651916cd43dd8448eb211c80319c-b7ad6b7169203331-01", context));
+        }
+    }
+    BENCHMARK(BM_TraceContext_Parse);
+}
@@ -0,0 +1,12 @@
+// GateServerȵ㺯΢׼ԣҪRedisMySQLVerifyServer
+//
+// ../GateServerĿ¼뱾Ŀ¼GateServerгmain.cppԴļ
+// GateServerԼGoogle Benchmarkbenchmark
+//
+// УڱĿ¼ִУȡĿ¼config.iniɶĽ
+//   GateMicroBench --benchmark_format=json --benchmark_out=result.json
+// ֻܲ --benchmark_filter=Jsonظȡλ --benchmark_repetitions=5
+// GATE_ALLOC_PROFILEʱÿεĶѷallocsֽalloc_bytes
+#include <benchmark/benchmark.h>
+
+BENCHMARK_MAIN();
@@ -0,0 +1,211 @@
+#include "AllocProfile.h"
+#include "ConfigMgr.h"
+#include "JsonWriter.h"
+#include "Logger.h"
+#include <cstdlib>
+#include <new>
+
+namespace {
+	// ÿ߳һۣһηʱȡ߳˳۱ۼֵȻ
+	struct ThreadCounters {
+		std::atomic<std::uint64_t> allocations{ 0 };
+		std::atomic<std::uint64_t> frees{ 0 };
+		std::atomic<std::uint64_t> bytes{ 0 };
+		std::atomic<const char*> name{ nullptr };
+	};
+
+	constexpr std::size_t MAX_THREADS = 256;
+	// Щȫֱǳʼģmain֮ǰķҲܰȫؼ
+	ThreadCounters g_threads[MAX_THREADS];
+	ThreadCounters g_overflow;					// MAX_THREADS̹߳ãҪԭӼ
+	std::atomic<std::size_t> g_thread_count{ 0 };
+
+	thread_local ThreadCounters* t_counters = nullptr;
+	thread_local AllocProfile::Tally* t_tally = nullptr;
+
+	ThreadCounters& Counters() {
+		if (t_counters == nullptr) {
+			auto index = g_thread_count.fetch_add(1, std::memory_order_relaxed);
+			t_counters = index < MAX_THREADS ? &g_threads[index] : &g_overflow;
+		}
+		return *t_counters;
+	}
+
+#ifdef GATE_ALLOC_PROFILE
+	// ԼĲֻб߳ддֿԭӼ
+	void Add(ThreadCounters& counters, std::atomic<std::uint64_t>& counter, std::uint64_t value) {
+		if (&counters == &g_overflow) {
+			counter.fetch_add(value, std::memory_order_relaxed);
+		}
+		else {
+			counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+		}
+	}
+
+	void OnAlloc(std::size_t size) {
+		auto& counters = Counters();
+		Add(counters, counters.allocations, 1);
+		Add(counters, counters.bytes, size);
+		if (t_tally != nullptr) {
+			t_tally->allocations.fetch_add(1, std::memory_order_relaxed);
+			t_tally->bytes.fetch_add(size, std::memory_order_relaxed);
+		}
+	}
+
+	void OnFree(void* ptr) {
+		if (ptr != nullptr) {
+			auto& counters = Counters();
+			Add(counters, counters.frees, 1);
+		}
+	}
+
+	void* Allocate(std::size_t size) {
+		OnAlloc(size);
+		void* ptr = std::malloc(size == 0 ? 1 : size);
+		if (ptr == nullptr) {
+			throw std::bad_alloc();
+		}
+		return ptr;
+	}
+
+	void* AllocateAligned(std::size_t size, std::align_val_t align) {
+		OnAlloc(size);
+		auto alignment = static_cast<std::size_t>(align);
+#ifdef _WIN32
+		void* ptr = _aligned_malloc(size == 0 ? 1 : size, alignment);
+#else
+		// aligned_allocҪСǶֵ
+		void* ptr = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+#endif
+		if (ptr == nullptr) {
+			throw std::bad_alloc();
+		}
+		return ptr;
+	}
+
+	void Free(void* ptr) {
+		OnFree(ptr);
+		std::free(ptr);
+	}
+
+	void FreeAligned(void* ptr) {
+		OnFree(ptr);
+#ifdef _WIN32
+		_aligned_free(ptr);
+#else
+		std::free(ptr);
+#endif
+	}
+#endif
+}
+
+#ifdef GATE_ALLOC_PROFILE
+void* operator new(std::size_t size) { return Allocate(size); }
+void* operator new[](std::size_t size) { return Allocate(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+	try { return Allocate(size); } catch (...) { return nullptr; }
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+	try { return Allocate(size); } catch (...) { return nullptr; }
+}
+void* operator new(std::size_t size, std::align_val_t align) { return AllocateAligned(size, align); }
+void* operator new[](std::size_t size, std::align_val_t align) { return AllocateAligned(size, align); }
+void* operator new(std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+	try { return AllocateAligned(size, align); } catch (...) { return nullptr; }
+}
+void* operator new[](std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+	try { return AllocateAligned(size, align); } catch (...) { return nullptr; }
+}
+
+void operator delete(void* ptr) noexcept { Free(ptr); }
+void operator delete[](void* ptr) noexcept { Free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { Free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { Free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { Free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { Free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { FreeAligned(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { FreeAligned(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { FreeAligned(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { FreeAligned(ptr); }
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { FreeAligned(ptr); }
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { FreeAligned(ptr); }
+#endif
+
+void AllocProfile::RouteCounts::Record(const Tally& tally, const std::string& route)
+{
+	auto allocs = tally.allocations.load(std::memory_order_relaxed);
+	requests.fetch_add(1, std::memory_order_relaxed);
+	allocations.fetch_add(allocs, std::memory_order_relaxed);
+	bytes.fetch_add(tally.bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+	auto threshold = WarnPerRequest();
+	if (threshold == 0 || allocs <= threshold) {
+		return;
+	}
+	auto count = over_threshold.fetch_add(1, std::memory_order_relaxed) + 1;
+	if ((count & (count - 1)) == 0) {
+		LOG_WARN("request of ", route, " made ", allocs, " allocations, over threshold ", threshold,
+			", ", count, " requests so far");
+	}
+}
+
+AllocProfile::Scope::Scope(Tally* tally) : _saved(t_tally)
+{
+	t_tally = tally;
+}
+
+AllocProfile::Scope::~Scope()
+{
+	t_tally = _saved;
+}
+
+AllocProfile::Tally* AllocProfile::Current()
+{
+	return t_tally;
+}
+
+AllocProfile::Tally* AllocProfile::Suspend()
+{
+	auto* tally = t_tally;
+	t_tally = nullptr;
+	return tally;
+}
+
+void AllocProfile::NameThread(const char* name)
+{
+	if constexpr (Enabled()) {
+		Counters().name.store(name, std::memory_order_relaxed);
+	}
+}
+
+void AllocProfile::RenderThreads(JsonWriter& writer)
+{
+	auto count = g_thread_count.load(std::memory_order_relaxed);
+	writer.BeginArray();
+	auto render = [&writer](std::int64_t index, const ThreadCounters& counters) {
+		const char* name = counters.name.load(std::memory_order_relaxed);
+		writer.BeginObject()
+			.Field("thread", index)
+			.Field("name", name ? name : "other")
+			.Field("allocations", static_cast<std::int64_t>(counters.allocations.load(std::memory_order_relaxed)))
+			.Field("frees", static_cast<std::int64_t>(counters.frees.load(std::memory_order_relaxed)))
+			.Field("bytes", static_cast<std::int64_t>(counters.bytes.load(std::memory_order_relaxed)))
+			.EndObject();
+	};
+	for (std::size_t i = 0; i < count && i < MAX_THREADS; ++i) {
+		render(static_cast<std::int64_t>(i), g_threads[i]);
+	}
+	if (count > MAX_THREADS) {
+		render(-1, g_overflow);
+	}
+	writer.EndArray();
+}
+
+std::uint64_t AllocProfile::WarnPerRequest()
+{
+	static const std::uint64_t threshold = []() {
+		std::string value = ConfigMgr::Inst()["AllocProfile"]["WarnPerRequest"];
+		return value.empty() ? 0 : std::strtoull(value.c_str(), nullptr, 10);
+	}();
+	return threshold;
+}
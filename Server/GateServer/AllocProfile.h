@@ -0,0 +1,70 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+class JsonWriter;
+
+// ѷͳƣGATE_ALLOC_PROFILEʱã
+//   1. 滻ȫoperator new/delete߳ͳƷͷŴͷֽ
+//   2. ScopeڷķͬʱǵScopeָTallyϣӵĻصЭ̺ͺִʱ
+//      ʹӵTallyӦд·ۼƣ/admin/allocЩ
+// δʱ滻operator newTallyʼΪ0Scopeֻлһֲָ߳̾
+class AllocProfile
+{
+public:
+	static constexpr bool Enabled() {
+#ifdef GATE_ALLOC_PROFILE
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	// һķ䣻Э̵ĺ˵ÿִ߳Уԭӱ
+	struct Tally {
+		std::atomic<std::uint64_t> allocations{ 0 };
+		std::atomic<std::uint64_t> bytes{ 0 };
+		void Clear() {
+			allocations.store(0, std::memory_order_relaxed);
+			bytes.store(0, std::memory_order_relaxed);
+		}
+	};
+
+	// һ·ۼƵķ
+	struct RouteCounts {
+		std::atomic<std::uint64_t> requests{ 0 };
+		std::atomic<std::uint64_t> allocations{ 0 };
+		std::atomic<std::uint64_t> bytes{ 0 };
+		std::atomic<std::uint64_t> over_threshold{ 0 };	// ķWarnPerRequest
+
+		// ۼһķ䣬ֵʱ2ݴμ־
+		void Record(const Tally& tally, const std::string& route);
+	};
+
+	// ڵǰ̵߳ķͬʱǵtallyϣǶףʱָtally
+	class Scope {
+	public:
+		explicit Scope(Tally* tally);
+		~Scope();
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+	private:
+		Tally* _saved;
+	};
+
+	// ǰ߳ڼ¼Tally
+	static Tally* Current();
+	// Э̹ǰãصǰTallyֹͣ¼ָʱScopeã
+	// ͬһ߳ӵķǵ
+	static Tally* Suspend();
+
+	// ǰ߳/admin/allocаio̺߳ͺ̣߳name볤Ч
+	static void NameThread(const char* name);
+
+	// дÿ̵߳ۼƷ䣺[{"thread":0,"name":"io","allocations":..,"frees":..,"bytes":..},...]
+	static void RenderThreads(JsonWriter& writer);
+
+	// config.ini[AllocProfile] WarnPerRequest0ʾ
+	static std::uint64_t WarnPerRequest();
+};
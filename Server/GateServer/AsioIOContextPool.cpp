@@ -1,40 +1,97 @@
 #include "AsioIOContextPool.h"
+#include "HttpConnectionPool.h"
+#include "AllocProfile.h"
 #include <iostream>
+#include <algorithm>
 
 AsioIOContextPool::AsioIOContextPool(std::size_t size) :
-	_ioContexts(size), _nextIOContext(0)
+	_ioContexts(size), _selector(size, IOContextSelector::ParsePolicy(ConfigMgr::Inst()["GateServer"]["IOContextPolicy"]))
 {
+	// ÿio߳໺ĿӶ
+	std::string max_idle_str = ConfigMgr::Inst()["GateServer"]["MaxIdleConnections"];
+	std::size_t max_idle = max_idle_str.empty() ? 1024 : static_cast<std::size_t>(atoi(max_idle_str.c_str()));
+	// ¼ѭ̽handler־ֵλ룬Ϊ0ʱֻͳhandler̽ӳ
+	std::string probe_str = ConfigMgr::Inst()["GateServer"]["LoopProbeInterval"];
+	std::string slow_str = ConfigMgr::Inst()["GateServer"]["SlowHandlerThreshold"];
+	std::chrono::milliseconds probe_interval(probe_str.empty() ? 100 : atoi(probe_str.c_str()));
+	std::chrono::milliseconds slow_threshold(slow_str.empty() ? 50 : atoi(slow_str.c_str()));
+
 	for (std::size_t i = 0; i < size; ++i)
 	{
 		_workGuards.push_back(
 			std::make_unique<WorkGuard>(
 				boost::asio::make_work_guard(_ioContexts[i])
 		));
+		_timerWheels.push_back(std::make_unique<TimerWheel>(_ioContexts[i]));
+		// ʱֻԼio߳ϲ
+		auto* wheel = _timerWheels.back().get();
+		boost::asio::post(_ioContexts[i], [wheel]() {
+			wheel->Start();
+			});
+		_connectionPools.push_back(std::make_shared<HttpConnectionPool>(_ioContexts[i], *wheel, _selector.Load(i), max_idle));
+		_loopMonitors.push_back(std::make_unique<LoopMonitor>(_ioContexts[i], i, probe_interval, slow_threshold));
+		auto* monitor = _loopMonitors.back().get();
+		boost::asio::post(_ioContexts[i], [monitor]() {
+			monitor->Start();
+			});
 	}
 
 	for (std::size_t i = 0; i < size; ++i)
 	{
 		_threads.emplace_back(
 			[this, i]() {
+				AllocProfile::NameThread("io");
 				_ioContexts[i].run();
 			});
 	}
 }
 
+std::size_t AsioIOContextPool::ConfiguredSize()
+{
+	std::string threads_str = ConfigMgr::Inst()["GateServer"]["IOThreads"];
+	int threads = atoi(threads_str.c_str());
+	if (threads > 0) {
+		return static_cast<std::size_t>(threads);
+	}
+	// hardware_concurrencyܷ0ٱһio߳
+	return std::max<std::size_t>(1, std::thread::hardware_concurrency());
+}
+
 AsioIOContextPool::~AsioIOContextPool()
 {
 	Stop();
+	// io߳Ѿ˳ͷŻӶio_contextʱٹ黹ֱ
+	for (auto& pool : _connectionPools) {
+		pool->Shutdown();
+	}
 	std::cout << "AsioIOContextPool destruct" << std::endl;
 }
 
 boost::asio::io_context& AsioIOContextPool::GetIOContext()
 {
-	auto& ioc = _ioContexts[_nextIOContext++];
-	if (_nextIOContext == _ioContexts.size())
-	{
-		_nextIOContext = 0;
-	}
-	return ioc;
+	return _ioContexts[_selector.Select()];
+}
+
+boost::asio::io_context& AsioIOContextPool::GetIOContext(std::size_t index)
+{
+	return _ioContexts[index % _ioContexts.size()];
+}
+
+std::size_t AsioIOContextPool::Size() const
+{
+	return _ioContexts.size();
+}
+
+TimerWheel& AsioIOContextPool::GetTimerWheel(boost::asio::io_context& ioc)
+{
+	std::size_t index = &ioc - _ioContexts.data();
+	return *_timerWheels[index];
+}
+
+HttpConnectionPool& AsioIOContextPool::GetConnectionPool(boost::asio::io_context& ioc)
+{
+	std::size_t index = &ioc - _ioContexts.data();
+	return *_connectionPools[index];
 }
 
 void AsioIOContextPool::Stop() {
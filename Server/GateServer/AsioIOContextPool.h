@@ -2,6 +2,11 @@
 #include <vector>
 #include <boost/asio.hpp>
 #include "Singleton.h"
+#include "TimerWheel.h"
+#include "LoopMonitor.h"
+#include "IOContextSelector.h"
+
+class HttpConnectionPool;
 
 class AsioIOContextPool:public Singleton<AsioIOContextPool>
 {
@@ -15,16 +20,29 @@ public:
 	AsioIOContextPool(const AsioIOContextPool&) = delete;
 	AsioIOContextPool& operator= (const AsioIOContextPool&) = delete;
 
-	// ʹround-robinѯ㷨ηزͬioc
+	// config.iniIOContextPolicyõĲΪѡiocĬѯڶacceptor߳ͬʱ
 	boost::asio::io_context& GetIOContext();
+	// ±귵iocڸÿio̰߳󶨸Եacceptor
+	boost::asio::io_context& GetIOContext(std::size_t index);
+	// ioģ̣߳
+	std::size_t Size() const;
+	// ioc̵߳ʱ֣iocԱ
+	TimerWheel& GetTimerWheel(boost::asio::io_context& ioc);
+	// iocӦHttpConnectionأiocԱ
+	HttpConnectionPool& GetConnectionPool(boost::asio::io_context& ioc);
 	// ֹͣioc
 	void Stop();
 
 private:
-	AsioIOContextPool(std::size_t = std::thread::hardware_concurrency());
+	AsioIOContextPool(std::size_t size = ConfiguredSize());
+	// [GateServer]IOThreadsõio߳ûûΪ0ʱʹCPU
+	static std::size_t ConfiguredSize();
 	std::vector<IOContext> _ioContexts;		// io
 	std::vector<WorkPtr> _workGuards;		// ָio
 	std::vector<std::thread> _threads;		// ߳
-	std::size_t _nextIOContext;				// һҪioѯ
+	std::vector<std::unique_ptr<TimerWheel>> _timerWheels;	// ÿio߳һʱ֣ͳһӳʱ
+	std::vector<std::shared_ptr<HttpConnectionPool>> _connectionPools;	// ÿio߳һӶ
+	std::vector<std::unique_ptr<LoopMonitor>> _loopMonitors;	// ÿio߳һ¼ѭ
+	IOContextSelector _selector;			// ѡԺÿioĵĸ
 };
 
@@ -0,0 +1,66 @@
+#include "BackendExecutor.h"
+
+BackendExecutor::BackendExecutor() : _pending(0), _max_pending(1024), _b_stop(false)
+{
+	auto& gCfgMgr = ConfigMgr::Inst();
+	std::string threads_str = gCfgMgr["Backend"]["Threads"];
+	std::string max_queue_str = gCfgMgr["Backend"]["MaxQueue"];
+
+	// ˵ûڵ磬߳Ĭϱio̶߳һЩ
+	std::size_t threads = std::thread::hardware_concurrency() * 2;
+	if (!threads_str.empty()) {
+		threads = static_cast<std::size_t>(atoi(threads_str.c_str()));
+	}
+	if (threads == 0) {
+		threads = 1;
+	}
+	if (!max_queue_str.empty()) {
+		_max_pending = static_cast<std::size_t>(atoi(max_queue_str.c_str()));
+	}
+	_pool = std::make_unique<boost::asio::thread_pool>(threads);
+}
+
+BackendExecutor::~BackendExecutor()
+{
+	Stop();
+}
+
+bool BackendExecutor::Post(std::function<void()> task)
+{
+	if (_b_stop) {
+		return false;
+	}
+
+	// ռλͶݣ
+	if (_pending.fetch_add(1) >= _max_pending) {
+		_pending.fetch_sub(1);
+		return false;
+	}
+
+	boost::asio::post(*_pool, [this, task = std::move(task)]() {
+		AllocProfile::NameThread("backend");
+		Defer defer([this]() {
+			_pending.fetch_sub(1);
+			});
+		try {
+			task();
+		}
+		catch (std::exception& exp) {
+			LOG_ERROR("backend task exception is ", exp.what());
+		}
+		});
+	return true;
+}
+
+std::size_t BackendExecutor::Pending() const
+{
+	return _pending.load();
+}
+
+void BackendExecutor::Stop()
+{
+	if (_b_stop.exchange(true)) {
+		return;
+	}
+	_pool->join();
+}
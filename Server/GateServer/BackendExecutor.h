@@ -0,0 +1,85 @@
+#pragma once
+#include "const.h"
+#include <boost/asio/thread_pool.hpp>
+#include "LoopMonitor.h"
+#include "AllocProfile.h"
+
+// ̳߳ŶʱЭ̽ӿ׳쳣תΪ503Ӧ
+class BackendBusyError : public std::runtime_error {
+public:
+	BackendBusyError() : std::runtime_error("backend executor is busy") {}
+};
+
+// async_initiateĳʼеãЭ̵ɻصװɿԸơ̵߳õĺ
+// Э̹ڼ䲻ټ¼䣻ʱѲͶݻЭԼִϻָָķǵԭ
+template <typename Executor, typename Handler>
+auto MakeResumer(const Executor& executor, Handler handler)
+{
+	auto* tally = AllocProfile::Suspend();
+	// Э̵ɻصֻƶһshared_ptrܷŽstd::function
+	auto shared_handler = std::make_shared<Handler>(std::move(handler));
+	return [executor, shared_handler, tally](auto... args) {
+		// صЭԼִϻָں̻߳CompletionQueueָ߳
+		net::post(executor, [shared_handler, tally, ...args = std::move(args)]() mutable {
+			// Эֱָһιhandler
+			LoopMonitor::Busy busy("coroutine resume");
+			AllocProfile::Scope alloc_scope(tally);
+			(*shared_handler)(std::move(args)...);
+			});
+	};
+}
+
+// ̳߳أִgRPCRedisMySQLãռio߳
+// ŶӵޣʱPostʧܣɵ÷ֱӷ503
+class BackendExecutor : public Singleton<BackendExecutor>
+{
+	friend class Singleton<BackendExecutor>;
+public:
+	~BackendExecutor();
+
+	// Ͷһ񣬶ֹͣfalse
+	bool Post(std::function<void()> task);
+	// Эʹãco_await BackendExecutor::GetInstance()->Run(work)
+	// workںִ̳߳УصЭڵִϣŶʱ׳BackendBusyError
+	template <typename Work>
+	net::awaitable<std::invoke_result_t<Work&>> Run(Work work);
+	// Ͷݵδִ
+	std::size_t Pending() const;
+	void Stop();
+
+private:
+	BackendExecutor();
+
+	std::unique_ptr<boost::asio::thread_pool> _pool;
+	std::atomic<std::size_t> _pending;
+	std::size_t _max_pending;
+	std::atomic<bool> _b_stop;
+};
+
+template <typename Work>
+net::awaitable<std::invoke_result_t<Work&>> BackendExecutor::Run(Work work)
+{
+	using Result = std::invoke_result_t<Work&>;
+	auto executor = co_await net::this_coro::executor;
+	co_return co_await net::async_initiate<const net::use_awaitable_t<>&, void(std::exception_ptr, Result)>(
+		[this, executor](auto handler, Work work) {
+			// ķҲǵ
+			auto* tally = AllocProfile::Current();
+			auto resume = MakeResumer(executor, std::move(handler));
+			bool posted = Post([resume, tally, work = std::move(work)]() mutable {
+				AllocProfile::Scope alloc_scope(tally);
+				std::exception_ptr error;
+				Result result{};
+				try {
+					result = work();
+				}
+				catch (...) {
+					error = std::current_exception();
+				}
+				resume(error, std::move(result));
+				});
+			if (!posted) {
+				resume(std::make_exception_ptr(BackendBusyError()), Result{});
+			}
+		}, net::use_awaitable, std::move(work));
+}
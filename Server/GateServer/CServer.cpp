@@ -1,19 +1,46 @@
 #include "CServer.h"
 #include "HttpConnection.h"
 #include "AsioIOContextPool.h"
+#include "HttpConnectionPool.h"
+#include "LoopMonitor.h"
+
+#ifdef SO_REUSEPORT
+using reuse_port_option = net::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>;
+#endif
 
 // 캯
-CServer::CServer(boost::asio::io_context& ioc, unsigned short& port) 
-	:_ioc(ioc),_acceptor(ioc, tcp::endpoint(tcp::v4(), port)){
+CServer::CServer(boost::asio::io_context& ioc, unsigned short& port, bool reuse_port)
+	:_ioc(ioc), _acceptor(ioc), _reuse_port(reuse_port && SupportReusePort()) {
+	tcp::endpoint endpoint(tcp::v4(), port);
+	_acceptor.open(endpoint.protocol());
+	_acceptor.set_option(tcp::acceptor::reuse_address(true));
+#ifdef SO_REUSEPORT
+	// acceptorͬһ˿ڣں˰ӷɢio߳
+	if (_reuse_port) {
+		_acceptor.set_option(reuse_port_option(true));
+	}
+#endif
+	_acceptor.bind(endpoint);
+	_acceptor.listen(net::socket_base::max_listen_connections);
+}
 
+bool CServer::SupportReusePort()
+{
+#ifdef SO_REUSEPORT
+	return true;
+#else
+	return false;
+#endif
 }
 
 // Start
 void CServer::Start()
 {
     auto self = shared_from_this();
-    auto& io_context = AsioIOContextPool::GetInstance()->GetIOContext();
-    std::shared_ptr<HttpConnection> new_con = std::make_shared<HttpConnection>(io_context);
+    // SO_REUSEPORTģʽacceptorڵiọ߳߳Ǩsocket
+    auto& io_context = _reuse_port ? _ioc : AsioIOContextPool::GetInstance()->GetIOContext();
+    // Ӹio̵߳ĶȡӶ󣬹رպԶո
+    std::shared_ptr<HttpConnection> new_con = AsioIOContextPool::GetInstance()->GetConnectionPool(io_context).Acquire();
     _acceptor.async_accept(new_con->GetSocket(), [self, new_con](beast::error_code ec) {
         try {
             //ӣ
@@ -22,12 +49,16 @@ void CServer::Start()
                 return;
             }
             //ӣHpptConnection
-            new_con->Start();
+            // ӵʱֻio߳ϲл߳
+            net::dispatch(new_con->GetSocket().get_executor(), [new_con]() {
+                LoopMonitor::Busy busy("accept");
+                new_con->Start();
+                });
             //
             self->Start();
         }
         catch (std::exception& exp) {
-            std::cout << "exception is " << exp.what() << std::endl;
+            LOG_ERROR("exception is ", exp.what());
             self->Start();
         }
         });
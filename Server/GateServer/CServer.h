@@ -5,12 +5,18 @@
 class CServer :public std::enable_shared_from_this<CServer>
 {
 public:
-    CServer(boost::asio::io_context& ioc, unsigned short& port);
+    // reuse_portΪtrueʱacceptorSO_REUSEPORTʽ󶨶˿ڣ
+    // յֱiocϴתAsioIOContextPoolе߳
+    CServer(boost::asio::io_context& ioc, unsigned short& port, bool reuse_port = false);
     void Start();
 
+    // ǰƽ̨Ƿ֧SO_REUSEPORT
+    static bool SupportReusePort();
+
 private:
     net::io_context& _ioc;
     tcp::acceptor  _acceptor;
+    bool _reuse_port;
     // boost::asio::ip::tcp::socket   _socket;
 };
 
@@ -0,0 +1,179 @@
+#include "CircuitBreaker.h"
+#include "ConfigMgr.h"
+#include "Logger.h"
+#include <algorithm>
+
+namespace {
+	std::int64_t ReadInt(const std::string& section, const std::string& key, std::int64_t default_value) {
+		std::string value = ConfigMgr::Inst()[section][key];
+		if (value.empty()) {
+			return default_value;
+		}
+		return std::max<std::int64_t>(0, atoll(value.c_str()));
+	}
+
+	const char* StateName(BreakerState state) {
+		switch (state) {
+		case BreakerState::Open:
+			return "open";
+		case BreakerState::HalfOpen:
+			return "half_open";
+		default:
+			return "closed";
+		}
+	}
+}
+
+CircuitBreakerOptions CircuitBreakerOptions::Load(const std::string& section)
+{
+	CircuitBreakerOptions options;
+	options.window = std::chrono::seconds(ReadInt(section, "BreakerWindow", 10));
+	options.min_requests = static_cast<std::uint32_t>(ReadInt(section, "BreakerMinRequests", options.min_requests));
+	options.failure_rate = static_cast<std::uint32_t>(ReadInt(section, "BreakerFailureRate", options.failure_rate));
+	options.open_time = std::chrono::milliseconds(ReadInt(section, "BreakerOpenTime", options.open_time.count()));
+	options.half_open_probes = std::max<std::uint32_t>(1,
+		static_cast<std::uint32_t>(ReadInt(section, "BreakerHalfOpenProbes", options.half_open_probes)));
+	return options;
+}
+
+CircuitBreaker::CircuitBreaker(const std::string& name, const CircuitBreakerOptions& options)
+	: _name(name)
+	, _options(options)
+	, _bucket_ms(std::max<std::int64_t>(1, options.window.count() / static_cast<std::int64_t>(BUCKETS)))
+	, _state(BreakerState::Closed)
+	, _open_until_ms(0)
+	, _probes_in_flight(0)
+	, _probe_successes(0)
+	, _state_gauge(Metrics::Inst().GetGauge("gate_breaker_state",
+		"Circuit breaker state: 0 closed, 1 open, 2 half-open", "breaker=\"" + name + "\""))
+	, _rejected(Metrics::Inst().GetCounter("gate_breaker_rejected_total",
+		"Calls failed fast by an open circuit breaker", "breaker=\"" + name + "\""))
+{
+	for (BreakerState state : { BreakerState::Closed, BreakerState::Open, BreakerState::HalfOpen }) {
+		_transitions[static_cast<int>(state)] = &Metrics::Inst().GetCounter("gate_breaker_transitions_total",
+			"Circuit breaker state changes by target state",
+			"breaker=\"" + name + "\",to=\"" + StateName(state) + "\"");
+	}
+}
+
+std::int64_t CircuitBreaker::NowMs() const
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now().time_since_epoch()).count();
+}
+
+bool CircuitBreaker::Allow()
+{
+	if (_options.min_requests == 0) {
+		return true;
+	}
+	BreakerState state = _state.load(std::memory_order_acquire);
+	if (state == BreakerState::Closed) {
+		return true;
+	}
+	std::int64_t now = NowMs();
+	if (state == BreakerState::Open && now < _open_until_ms.load(std::memory_order_relaxed)) {
+		_rejected.Inc();
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	state = _state.load(std::memory_order_relaxed);
+	if (state == BreakerState::Closed) {
+		return true;
+	}
+	if (state == BreakerState::Open) {
+		if (now < _open_until_ms.load(std::memory_order_relaxed)) {
+			_rejected.Inc();
+			return false;
+		}
+		Transition(BreakerState::HalfOpen, now);
+	}
+	// 뿪;ѳɹ̽õ
+	if (_probes_in_flight + _probe_successes < _options.half_open_probes) {
+		++_probes_in_flight;
+		return true;
+	}
+	_rejected.Inc();
+	return false;
+}
+
+void CircuitBreaker::OnResult(bool success)
+{
+	if (_options.min_requests == 0) {
+		return;
+	}
+	std::int64_t now = NowMs();
+	std::lock_guard<std::mutex> lock(_mutex);
+	switch (_state.load(std::memory_order_relaxed)) {
+	case BreakerState::Closed:
+		Record(now, success);
+		if (!success && ShouldOpen(now)) {
+			Transition(BreakerState::Open, now);
+		}
+		break;
+	case BreakerState::HalfOpen:
+		// ֮ǰеĵÿڰ뿪ʱŻҲ̽
+		if (_probes_in_flight > 0) {
+			--_probes_in_flight;
+		}
+		if (!success) {
+			Transition(BreakerState::Open, now);
+		}
+		else if (++_probe_successes >= _options.half_open_probes) {
+			Transition(BreakerState::Closed, now);
+		}
+		break;
+	case BreakerState::Open:
+		// ֮ǰеĵãӰ״̬
+		break;
+	}
+}
+
+bool CircuitBreaker::Rejecting() const
+{
+	return _state.load(std::memory_order_acquire) == BreakerState::Open
+		&& NowMs() < _open_until_ms.load(std::memory_order_relaxed);
+}
+
+void CircuitBreaker::Record(std::int64_t now_ms, bool success)
+{
+	std::int64_t epoch = now_ms / _bucket_ms;
+	Bucket& bucket = _buckets[static_cast<std::size_t>(epoch) % BUCKETS];
+	if (bucket.epoch != epoch) {
+		bucket = Bucket();
+		bucket.epoch = epoch;
+	}
+	++(success ? bucket.successes : bucket.failures);
+}
+
+bool CircuitBreaker::ShouldOpen(std::int64_t now_ms) const
+{
+	std::int64_t oldest = now_ms / _bucket_ms - static_cast<std::int64_t>(BUCKETS) + 1;
+	std::uint64_t total = 0;
+	std::uint64_t failures = 0;
+	for (const auto& bucket : _buckets) {
+		if (bucket.epoch >= oldest) {
+			total += bucket.successes + bucket.failures;
+			failures += bucket.failures;
+		}
+	}
+	return total >= _options.min_requests && failures * 100 >= total * _options.failure_rate;
+}
+
+void CircuitBreaker::Transition(BreakerState to, std::int64_t now_ms)
+{
+	BreakerState from = _state.load(std::memory_order_relaxed);
+	if (to == BreakerState::Open) {
+		_open_until_ms.store(now_ms + _options.open_time.count(), std::memory_order_relaxed);
+	}
+	// ÿν뿪㿪ʼ̽رʱմڣôǰʧٴδ
+	_probes_in_flight = 0;
+	_probe_successes = 0;
+	if (to == BreakerState::Closed) {
+		_buckets.fill(Bucket());
+	}
+	_state.store(to, std::memory_order_release);
+	_state_gauge.Set(static_cast<std::int64_t>(to));
+	_transitions[static_cast<int>(to)]->Inc();
+	LOG_WARN("circuit breaker ", _name, ": ", StateName(from), " -> ", StateName(to));
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include "Metrics.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+enum class BreakerState {
+	Closed = 0,		// Уͳʧ
+	Open = 1,		// ֱӾܾʱ뿪
+	HalfOpen = 2,	// ̽
+};
+
+// ۶ãȡconfig.iniĳΣ[VarifyServer]
+//   BreakerWindow          ͳʧʵĻڣ룩ֳ10ͰĬ10
+//   BreakerMinRequests     ڵĵﵽôжʧʣĬ200ʾ۶
+//   BreakerFailureRate     ʧʴﵽٷֱʱ򿪣Ĭ50
+//   BreakerOpenTime        򿪺ã룩뿪Ĭ5000
+//   BreakerHalfOpenProbes  뿪ʱе̽ȫɹŹرգһʧ´򿪣Ĭ3
+struct CircuitBreakerOptions {
+	std::chrono::milliseconds window{ 10000 };
+	std::uint32_t min_requests = 20;
+	std::uint32_t failure_rate = 50;
+	std::chrono::milliseconds open_time{ 5000 };
+	std::uint32_t half_open_probes = 3;
+
+	static CircuitBreakerOptions Load(const std::string& section);
+};
+
+// ۶ʱŶӵȳʱֱʧܣ
+// ״̬仯д־gate_breaker_state{breaker="<name>"}gate_breaker_transitions_total
+class CircuitBreaker
+{
+public:
+	CircuitBreaker(const std::string& name, const CircuitBreakerOptions& options);
+	CircuitBreaker(const CircuitBreaker&) = delete;
+	CircuitBreaker& operator=(const CircuitBreaker&) = delete;
+
+	// ǷһεãеĵýOnResultܾĲ
+	bool Allow();
+	void OnResult(bool success);
+	// ڴ״̬һû뿪ʱ䣻ֻı״̬÷׼֮ǰʧ
+	bool Rejecting() const;
+	BreakerState State() const {
+		return _state.load(std::memory_order_acquire);
+	}
+
+private:
+	typedef std::chrono::steady_clock Clock;
+	static constexpr std::size_t BUCKETS = 10;
+
+	struct Bucket {
+		std::int64_t epoch = -1;	// ͰӦʱƬ
+		std::uint32_t successes = 0;
+		std::uint32_t failures = 0;
+	};
+
+	std::int64_t NowMs() const;
+	void Record(std::int64_t now_ms, bool success);
+	bool ShouldOpen(std::int64_t now_ms) const;
+	void Transition(BreakerState to, std::int64_t now_ms);
+
+	std::string _name;
+	CircuitBreakerOptions _options;
+	std::int64_t _bucket_ms;
+	std::atomic<BreakerState> _state;
+	std::atomic<std::int64_t> _open_until_ms;		// ״̬ʱ䣨steady_clock룩
+	std::mutex _mutex;								// ֶκ״̬ת
+	std::array<Bucket, BUCKETS> _buckets;
+	std::uint32_t _probes_in_flight;
+	std::uint32_t _probe_successes;
+	Gauge& _state_gauge;
+	Counter& _rejected;
+	Counter* _transitions[3];
+};
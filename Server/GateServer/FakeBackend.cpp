@@ -0,0 +1,101 @@
+#include "FakeBackend.h"
+#include "ConfigMgr.h"
+#include "FakeRedisServer.h"
+#include "FakeVerifyServer.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <thread>
+
+namespace {
+	std::mt19937_64& Random() {
+		thread_local std::mt19937_64 engine(std::random_device{}());
+		return engine;
+	}
+
+	std::chrono::microseconds Millis(const std::string& value) {
+		if (value.empty()) {
+			return std::chrono::microseconds(0);
+		}
+		// дʱstrtod0쳣0
+		double ms = std::max(std::strtod(value.c_str(), nullptr), 0.0);
+		return std::chrono::microseconds(static_cast<long long>(ms * 1000));
+	}
+
+	std::unique_ptr<FakeRedisServer> g_redis;
+	std::unique_ptr<FakeVerifyServer> g_verify;
+}
+
+FakeBehavior FakeBehavior::Load(const std::string& name)
+{
+	auto section = ConfigMgr::Inst()["FakeBackend"];
+	FakeBehavior behavior;
+	std::string enabled = section[name];
+	behavior.enabled = enabled == "true" || enabled == "1";
+	behavior.latency = Millis(section[name + "Latency"]);
+	behavior.jitter = Millis(section[name + "Jitter"]);
+	std::string rate = section[name + "ErrorRate"];
+	behavior.error_rate = std::clamp(std::strtod(rate.c_str(), nullptr), 0.0, 1.0);
+	return behavior;
+}
+
+std::chrono::microseconds FakeBehavior::NextLatency() const
+{
+	if (jitter.count() <= 0) {
+		return latency;
+	}
+	std::uniform_int_distribution<long long> dist(0, jitter.count() - 1);
+	return latency + std::chrono::microseconds(dist(Random()));
+}
+
+bool FakeBehavior::NextError() const
+{
+	if (error_rate <= 0) {
+		return false;
+	}
+	return std::uniform_real_distribution<double>(0, 1)(Random()) < error_rate;
+}
+
+void FakeBehavior::Sleep() const
+{
+	auto delay = NextLatency();
+	if (delay.count() > 0) {
+		std::this_thread::sleep_for(delay);
+	}
+}
+
+void FakeBackends::Start()
+{
+	auto& cfg = ConfigMgr::Inst();
+	auto redis = FakeBehavior::Load("Redis");
+	if (redis.enabled) {
+		std::string port = cfg["Redis"]["Port"];
+		g_redis = std::make_unique<FakeRedisServer>(redis);
+		g_redis->Start(cfg["Redis"]["Host"], static_cast<unsigned short>(atoi(port.c_str())));
+		LOG_INFO("fake redis listen on ", cfg["Redis"]["Host"], ":", port);
+	}
+	auto verify = FakeBehavior::Load("Verify");
+	if (verify.enabled) {
+		std::string address = cfg["VarifyServer"]["Host"] + ":" + cfg["VarifyServer"]["Port"];
+		g_verify = std::make_unique<FakeVerifyServer>(verify);
+		g_verify->Start(address);
+		LOG_INFO("fake verify server listen on ", address);
+	}
+	if (FakeBehavior::Load("Mysql").enabled) {
+		LOG_INFO("using in-memory mysql dao");
+	}
+}
+
+void FakeBackends::Stop()
+{
+	if (g_verify) {
+		g_verify->Stop();
+		g_verify.reset();
+	}
+	if (g_redis) {
+		g_redis->Stop();
+		g_redis.reset();
+	}
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <chrono>
+#include <string>
+
+// ٺ˵Ϊãȡconfig.ini[FakeBackend]nameΪǰ׺ļ
+//   <name> = true            ʹýڵļٺ˴ʵRedisMySQLVerifyServer
+//   <name>Latency = 2        ÿεãRedisSQL䡢RPC̶ӵӳ٣λ룬ԴС
+//   <name>Jitter = 1         ڹ̶ӳټ[0, Jitter)ľӳ
+//   <name>ErrorRate = 0.01   ʧܵĸ
+struct FakeBehavior {
+	bool enabled = false;
+	std::chrono::microseconds latency{ 0 };
+	std::chrono::microseconds jitter{ 0 };
+	double error_rate = 0;
+
+	static FakeBehavior Load(const std::string& name);
+
+	// εõӳ٣ֲ߳̾ģ̵߳
+	std::chrono::microseconds NextLatency() const;
+	// εǷע
+	bool NextError() const;
+	// ǰ߳NextLatency()ʱ䣬ںִ̳߳еͬ
+	void Sleep() const;
+};
+
+// ֹͣٵRedisVerifyServerMySQLļʵMysqlMgrԼѡ
+// ڵһʹRedisMgrVerifyGrpcClient֮ǰStartڹʱͻὨ
+class FakeBackends {
+public:
+	static void Start();
+	static void Stop();
+};
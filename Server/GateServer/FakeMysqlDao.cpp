@@ -0,0 +1,135 @@
+#include "FakeMysqlDao.h"
+#include "Tracer.h"
+
+FakeMysqlDao::FakeMysqlDao(const FakeBehavior& behavior)
+    : MysqlDao(nullptr), _behavior(behavior)
+{
+}
+
+bool FakeMysqlDao::Execute(std::string_view statement)
+{
+    Span span(Tracer::Current(), statement, SpanKind::Client);
+    span.SetAttribute("db.system", "mysql");
+    _behavior.Sleep();
+    if (_behavior.NextError()) {
+        span.SetError("injected failure");
+        LOG_ERROR("Error: injected failure in ", statement);
+        return false;
+    }
+    return true;
+}
+
+int FakeMysqlDao::Insert(const std::string& name, const std::string& email, const std::string& pwd)
+{
+    if (_emails.count(email) > 0) {
+        LOG_DEBUG("email ", email, " exist");
+        return 0;
+    }
+    if (_users.count(name) > 0) {
+        LOG_DEBUG("name ", name, " exist");
+        return 0;
+    }
+    UserInfo user;
+    user.uid = ++_last_uid;
+    user.name = name;
+    user.email = email;
+    user.pwd = pwd;
+    _users.emplace(name, user);
+    _emails.emplace(email, name);
+    return user.uid;
+}
+
+int FakeMysqlDao::RegUser(const std::string& name, const std::string& email, const std::string& pwd)
+{
+    if (!Execute("mysql CALL reg_user")) {
+        return -1;
+    }
+    std::lock_guard<std::mutex> lock(_mutex);
+    return Insert(name, email, pwd);
+}
+
+int FakeMysqlDao::RegUserTransaction(const std::string& name, const std::string& email, const std::string& pwd)
+{
+    // MysqlDaoһִύ;κһʧܶع
+    // ûѴʱڶӦSELECT֮ͷ0ִк
+    if (!Execute("mysql SELECT user.email")) {
+        return -1;
+    }
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_emails.count(email) > 0) {
+            LOG_DEBUG("email ", email, " exist");
+            return 0;
+        }
+    }
+    if (!Execute("mysql SELECT user.name")) {
+        return -1;
+    }
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_users.count(name) > 0) {
+            LOG_DEBUG("name ", name, " exist");
+            return 0;
+        }
+    }
+    for (auto statement : { "mysql UPDATE user_id", "mysql SELECT user_id", "mysql INSERT user", "mysql COMMIT" }) {
+        if (!Execute(statement)) {
+            return -1;
+        }
+    }
+    // ǰ֮вעͬһûInsertټһ
+    std::lock_guard<std::mutex> lock(_mutex);
+    return Insert(name, email, pwd);
+}
+
+bool FakeMysqlDao::CheckEmail(const std::string& name, const std::string& email)
+{
+    if (!Execute("mysql SELECT user.email")) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto iter = _users.find(name);
+    return iter != _users.end() && iter->second.email == email;
+}
+
+bool FakeMysqlDao::UpdatePwd(const std::string& name, const std::string& newpwd)
+{
+    if (!Execute("mysql UPDATE user.pwd")) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto iter = _users.find(name);
+    if (iter != _users.end()) {
+        iter->second.pwd = newpwd;
+    }
+    return true;
+}
+
+bool FakeMysqlDao::CheckPwd(const std::string& name, const std::string& pwd, UserInfo& userInfo)
+{
+    if (!Execute("mysql SELECT user")) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto iter = _users.find(name);
+    if (iter == _users.end() || iter->second.pwd != pwd) {
+        return false;
+    }
+    userInfo = iter->second;
+    return true;
+}
+
+bool FakeMysqlDao::TestProcedure(const std::string& email, int& uid, std::string& name)
+{
+    if (!Execute("mysql CALL test_procedure")) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto iter = _emails.find(email);
+    if (iter == _emails.end()) {
+        return false;
+    }
+    name = iter->second;
+    uid = _users[name].uid;
+    return true;
+}
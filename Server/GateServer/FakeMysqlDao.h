@@ -0,0 +1,30 @@
+#pragma once
+#include "MysqlDao.h"
+#include "FakeBackend.h"
+#include <unordered_map>
+
+// MysqlDaoڴʵ֣MySQL˳ݶʧ
+// ÿ䰴FakeBehavior߳һʱ䣬ʧܣӳһ-1false
+// spanֺMysqlDaoһ£·׷ٵĽֱӶԱ
+class FakeMysqlDao : public MysqlDao
+{
+public:
+    explicit FakeMysqlDao(const FakeBehavior& behavior);
+    int RegUser(const std::string& name, const std::string& email, const std::string& pwd) override;
+    int RegUserTransaction(const std::string& name, const std::string& email, const std::string& pwd) override;
+    bool CheckEmail(const std::string& name, const std::string& email) override;
+    bool UpdatePwd(const std::string& name, const std::string& newpwd) override;
+    bool CheckPwd(const std::string& name, const std::string& pwd, UserInfo& userInfo) override;
+    bool TestProcedure(const std::string& email, int& uid, std::string& name) override;
+private:
+    // ģִһ䣺spanȴӳ٣falseʾע˴
+    bool Execute(std::string_view statement);
+    // ظ䲢룬ǰѴʱ0
+    int Insert(const std::string& name, const std::string& email, const std::string& pwd);
+
+    FakeBehavior _behavior;
+    std::mutex _mutex;
+    std::unordered_map<std::string, UserInfo> _users;       // name -> û
+    std::unordered_map<std::string, std::string> _emails;   // email -> name
+    int _last_uid = 0;
+};
@@ -0,0 +1,397 @@
+#include "FakeRedisServer.h"
+#include <algorithm>
+#include <cctype>
+
+namespace {
+	void Status(std::string& out, std::string_view status) {
+		out.append("+").append(status).append("\r\n");
+	}
+
+	void Error(std::string& out, std::string_view message) {
+		out.append("-").append(message).append("\r\n");
+	}
+
+	void Integer(std::string& out, long long value) {
+		out.append(":").append(std::to_string(value)).append("\r\n");
+	}
+
+	void Bulk(std::string& out, std::string_view value) {
+		out.append("$").append(std::to_string(value.size())).append("\r\n").append(value).append("\r\n");
+	}
+
+	void Nil(std::string& out) {
+		out.append("$-1\r\n");
+	}
+
+	// ȡһУ\r\nݲʱfalse
+	bool ReadLine(std::string_view in, std::size_t& pos, std::string_view& line) {
+		auto end = in.find("\r\n", pos);
+		if (end == std::string_view::npos) {
+			return false;
+		}
+		line = in.substr(pos, end - pos);
+		pos = end + 2;
+		return true;
+	}
+
+	// һhiredis͵Ķ*<n>\r\n$<len>\r\n<arg>\r\n...ʽҲtelnetʽ
+	// 1ʾһ0ʾݲ-1ʾЭ
+	int ParseCommand(std::string_view in, std::vector<std::string>& args, std::size_t& consumed) {
+		args.clear();
+		std::size_t pos = 0;
+		std::string_view line;
+		if (!ReadLine(in, pos, line)) {
+			return 0;
+		}
+		if (line.empty() || line[0] != '*') {
+			std::size_t start = 0;
+			while (start < line.size()) {
+				auto end = line.find(' ', start);
+				if (end == std::string_view::npos) {
+					end = line.size();
+				}
+				if (end > start) {
+					args.emplace_back(line.substr(start, end - start));
+				}
+				start = end + 1;
+			}
+			consumed = pos;
+			return 1;
+		}
+		int count = atoi(std::string(line.substr(1)).c_str());
+		if (count <= 0) {
+			return -1;
+		}
+		for (int i = 0; i < count; ++i) {
+			if (!ReadLine(in, pos, line)) {
+				return 0;
+			}
+			if (line.empty() || line[0] != '$') {
+				return -1;
+			}
+			long long len = atoll(std::string(line.substr(1)).c_str());
+			if (len < 0) {
+				return -1;
+			}
+			if (in.size() < pos + len + 2) {
+				return 0;
+			}
+			args.emplace_back(in.substr(pos, static_cast<std::size_t>(len)));
+			pos += static_cast<std::size_t>(len) + 2;
+		}
+		consumed = pos;
+		return 1;
+	}
+}
+
+FakeRedisServer::FakeRedisServer(const FakeBehavior& behavior)
+	: _behavior(behavior), _ioc(1), _acceptor(_ioc)
+{
+}
+
+FakeRedisServer::~FakeRedisServer()
+{
+	Stop();
+}
+
+void FakeRedisServer::Start(const std::string& host, unsigned short port)
+{
+	tcp::endpoint endpoint(net::ip::make_address(host.empty() ? "127.0.0.1" : host), port);
+	_acceptor.open(endpoint.protocol());
+	_acceptor.set_option(tcp::acceptor::reuse_address(true));
+	_acceptor.bind(endpoint);
+	_acceptor.listen();
+	Accept();
+	_thread = std::thread([this]() {
+		_ioc.run();
+		});
+}
+
+void FakeRedisServer::Stop()
+{
+	_ioc.stop();
+	if (_thread.joinable()) {
+		_thread.join();
+	}
+}
+
+void FakeRedisServer::Accept()
+{
+	_acceptor.async_accept([this](beast::error_code ec, tcp::socket socket) {
+		if (ec) {
+			if (ec != net::error::operation_aborted) {
+				LOG_WARN("fake redis accept failed: ", ec.message());
+			}
+			return;
+		}
+		socket.set_option(tcp::no_delay(true));
+		net::co_spawn(_ioc, Session(std::move(socket)), net::detached);
+		Accept();
+		});
+}
+
+net::awaitable<void> FakeRedisServer::Session(tcp::socket socket)
+{
+	net::steady_timer timer(_ioc);
+	std::string in;
+	std::string out;
+	std::vector<std::string> args;
+	char buffer[4096];
+	try {
+		for (;;) {
+			std::size_t n = co_await socket.async_read_some(net::buffer(buffer), net::use_awaitable);
+			in.append(buffer, n);
+
+			// һζĶhiredispipelineִУӦϲд
+			std::size_t pos = 0;
+			for (;;) {
+				std::size_t consumed = 0;
+				int res = ParseCommand(std::string_view(in).substr(pos), args, consumed);
+				if (res < 0) {
+					Error(out, "ERR Protocol error");
+					co_await net::async_write(socket, net::buffer(out), net::use_awaitable);
+					co_return;
+				}
+				if (res == 0) {
+					break;
+				}
+				pos += consumed;
+				if (args.empty()) {
+					continue;
+				}
+				auto delay = _behavior.NextLatency();
+				if (delay.count() > 0) {
+					timer.expires_after(delay);
+					co_await timer.async_wait(net::use_awaitable);
+				}
+				Execute(args, out);
+			}
+			in.erase(0, pos);
+
+			if (!out.empty()) {
+				co_await net::async_write(socket, net::buffer(out), net::use_awaitable);
+				out.clear();
+			}
+		}
+	}
+	catch (const std::exception&) {
+		// ͻ˶Ͽֹͣ
+	}
+}
+
+FakeRedisServer::Value* FakeRedisServer::Lookup(const std::string& key)
+{
+	auto iter = _data.find(key);
+	if (iter == _data.end()) {
+		return nullptr;
+	}
+	if (iter->second.expire && *iter->second.expire <= Clock::now()) {
+		_data.erase(iter);
+		return nullptr;
+	}
+	return &iter->second;
+}
+
+FakeRedisServer::Value* FakeRedisServer::Find(const std::string& key, Value::Type type, std::string& out, bool& wrong_type)
+{
+	wrong_type = false;
+	auto* value = Lookup(key);
+	if (value && value->type != type) {
+		Error(out, "WRONGTYPE Operation against a key holding the wrong kind of value");
+		wrong_type = true;
+		return nullptr;
+	}
+	return value;
+}
+
+void FakeRedisServer::Execute(std::vector<std::string>& args, std::string& out)
+{
+	std::string& cmd = args[0];
+	std::transform(cmd.begin(), cmd.end(), cmd.begin(), [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+
+	// ӹע󣬷ӳؽ
+	if (cmd == "AUTH" || cmd == "SELECT") {
+		Status(out, "OK");
+		return;
+	}
+	if (cmd == "PING") {
+		Status(out, "PONG");
+		return;
+	}
+	if (_behavior.NextError()) {
+		Error(out, "ERR injected failure");
+		return;
+	}
+
+	auto wrong_args = [&]() {
+		Error(out, "ERR wrong number of arguments for '" + cmd + "' command");
+	};
+	bool wrong_type = false;
+
+	if (cmd == "GET") {
+		if (args.size() != 2) {
+			return wrong_args();
+		}
+		auto* value = Find(args[1], Value::Type::String, out, wrong_type);
+		if (wrong_type) {
+			return;
+		}
+		value ? Bulk(out, value->str) : Nil(out);
+	}
+	else if (cmd == "SET") {
+		if (args.size() != 3 && args.size() != 5) {
+			return wrong_args();
+		}
+		Value value;
+		value.str = std::move(args[2]);
+		if (args.size() == 5) {
+			std::string option = args[3];
+			std::transform(option.begin(), option.end(), option.begin(), [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+			long long amount = atoll(args[4].c_str());
+			if (amount <= 0 || (option != "EX" && option != "PX")) {
+				return Error(out, "ERR syntax error");
+			}
+			value.expire = Clock::now() + (option == "EX" ? std::chrono::milliseconds(amount * 1000) : std::chrono::milliseconds(amount));
+		}
+		_data[args[1]] = std::move(value);
+		Status(out, "OK");
+	}
+	else if (cmd == "DEL" || cmd == "EXISTS") {
+		if (args.size() < 2) {
+			return wrong_args();
+		}
+		long long count = 0;
+		for (std::size_t i = 1; i < args.size(); ++i) {
+			if (!Lookup(args[i])) {
+				continue;
+			}
+			++count;
+			if (cmd == "DEL") {
+				_data.erase(args[i]);
+			}
+		}
+		Integer(out, count);
+	}
+	else if (cmd == "EXPIRE") {
+		if (args.size() != 3) {
+			return wrong_args();
+		}
+		auto* value = Lookup(args[1]);
+		if (!value) {
+			return Integer(out, 0);
+		}
+		// Redisһʱ䲻Ϊʱֱɾkey
+		long long seconds = atoll(args[2].c_str());
+		if (seconds <= 0) {
+			_data.erase(args[1]);
+		}
+		else {
+			value->expire = Clock::now() + std::chrono::seconds(seconds);
+		}
+		Integer(out, 1);
+	}
+	else if (cmd == "LPUSH" || cmd == "RPUSH") {
+		if (args.size() < 3) {
+			return wrong_args();
+		}
+		auto* value = Find(args[1], Value::Type::List, out, wrong_type);
+		if (wrong_type) {
+			return;
+		}
+		if (value == nullptr) {
+			value = &_data[args[1]];
+			*value = Value();
+			value->type = Value::Type::List;
+		}
+		for (std::size_t i = 2; i < args.size(); ++i) {
+			if (cmd == "LPUSH") {
+				value->list.push_front(std::move(args[i]));
+			}
+			else {
+				value->list.push_back(std::move(args[i]));
+			}
+		}
+		Integer(out, static_cast<long long>(value->list.size()));
+	}
+	else if (cmd == "LPOP" || cmd == "RPOP") {
+		if (args.size() != 2) {
+			return wrong_args();
+		}
+		auto* value = Find(args[1], Value::Type::List, out, wrong_type);
+		if (wrong_type) {
+			return;
+		}
+		if (value == nullptr) {
+			return Nil(out);
+		}
+		if (cmd == "LPOP") {
+			Bulk(out, value->list.front());
+			value->list.pop_front();
+		}
+		else {
+			Bulk(out, value->list.back());
+			value->list.pop_back();
+		}
+		if (value->list.empty()) {
+			_data.erase(args[1]);
+		}
+	}
+	else if (cmd == "HSET") {
+		if (args.size() < 4 || args.size() % 2 != 0) {
+			return wrong_args();
+		}
+		auto* value = Find(args[1], Value::Type::Hash, out, wrong_type);
+		if (wrong_type) {
+			return;
+		}
+		if (value == nullptr) {
+			value = &_data[args[1]];
+			*value = Value();
+			value->type = Value::Type::Hash;
+		}
+		long long added = 0;
+		for (std::size_t i = 2; i + 1 < args.size(); i += 2) {
+			added += value->hash.insert_or_assign(std::move(args[i]), std::move(args[i + 1])).second ? 1 : 0;
+		}
+		Integer(out, added);
+	}
+	else if (cmd == "HGET") {
+		if (args.size() != 3) {
+			return wrong_args();
+		}
+		auto* value = Find(args[1], Value::Type::Hash, out, wrong_type);
+		if (wrong_type) {
+			return;
+		}
+		if (value == nullptr) {
+			return Nil(out);
+		}
+		auto iter = value->hash.find(args[2]);
+		if (iter == value->hash.end()) {
+			return Nil(out);
+		}
+		Bulk(out, iter->second);
+	}
+	else if (cmd == "HDEL") {
+		if (args.size() < 3) {
+			return wrong_args();
+		}
+		auto* value = Find(args[1], Value::Type::Hash, out, wrong_type);
+		if (wrong_type) {
+			return;
+		}
+		long long removed = 0;
+		if (value != nullptr) {
+			for (std::size_t i = 2; i < args.size(); ++i) {
+				removed += static_cast<long long>(value->hash.erase(args[i]));
+			}
+			if (value->hash.empty()) {
+				_data.erase(args[1]);
+			}
+		}
+		Integer(out, removed);
+	}
+	else {
+		Error(out, "ERR unknown command '" + cmd + "'");
+	}
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include "const.h"
+#include "FakeBackend.h"
+#include <deque>
+#include <optional>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// ڵRESPʵRedisֻʵRedisMgrVerifyServerGateBenchõ
+//   AUTH PING SELECT GET SET(EX/PX) DEL EXISTS EXPIRE LPUSH RPUSH LPOP RPOP HSET HGET HDEL
+// ִСдAUTHУ룻ֻڴУڵkeyڷʱɾ
+// Լ߳Уֻ߳ϷʣҪ
+// ÿִǰFakeBehaviorȴһʱ䣨öʱӣʷش
+class FakeRedisServer
+{
+public:
+	explicit FakeRedisServer(const FakeBehavior& behavior);
+	~FakeRedisServer();
+
+	// host:porṭ߳˿ڱռʱ׳쳣
+	void Start(const std::string& host, unsigned short port);
+	void Stop();
+
+private:
+	using Clock = std::chrono::steady_clock;
+	struct Value {
+		enum class Type { String, List, Hash } type = Type::String;
+		std::string str;
+		std::deque<std::string> list;
+		std::unordered_map<std::string, std::string> hash;
+		std::optional<Clock::time_point> expire;
+	};
+
+	void Accept();
+	net::awaitable<void> Session(tcp::socket socket);
+	// ִһӦ׷ӵout
+	void Execute(std::vector<std::string>& args, std::string& out);
+	// keyѹڵ˳ɾؿգ
+	Value* Lookup(const std::string& key);
+	// δڵkeyͲʱoutдWRONGTYPEؿ
+	Value* Find(const std::string& key, Value::Type type, std::string& out, bool& wrong_type);
+
+	FakeBehavior _behavior;
+	net::io_context _ioc;
+	tcp::acceptor _acceptor;
+	std::thread _thread;
+	std::unordered_map<std::string, Value> _data;
+};
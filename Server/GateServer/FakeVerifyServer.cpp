@@ -0,0 +1,87 @@
+#include "FakeVerifyServer.h"
+#include "RedisMgr.h"
+#include "Tracer.h"
+#include <random>
+#include <stdexcept>
+
+namespace {
+	// server.jsеErrorsһ
+	enum VerifyErrors {
+		VerifySuccess = 0,
+		VerifyRedisErr = 1,
+	};
+
+	// uuidv4().substring(0, 4)
+	std::string NewCode() {
+		thread_local std::mt19937 engine(std::random_device{}());
+		static const char digits[] = "0123456789abcdef";
+		std::uniform_int_distribution<int> dist(0, 15);
+		std::string code(4, '0');
+		for (auto& c : code) {
+			c = digits[dist(engine)];
+		}
+		return code;
+	}
+}
+
+FakeVerifyServer::FakeVerifyServer(const FakeBehavior& behavior)
+	: _behavior(behavior)
+{
+}
+
+FakeVerifyServer::~FakeVerifyServer()
+{
+	Stop();
+}
+
+void FakeVerifyServer::Start(const std::string& address)
+{
+	grpc::ServerBuilder builder;
+	builder.AddListeningPort(address, grpc::InsecureServerCredentials());
+	builder.RegisterService(this);
+	_server = builder.BuildAndStart();
+	if (!_server) {
+		throw std::runtime_error("fake verify server listen on " + address + " failed");
+	}
+}
+
+void FakeVerifyServer::Stop()
+{
+	if (_server) {
+		_server->Shutdown();
+		_server.reset();
+	}
+}
+
+grpc::Status FakeVerifyServer::GetVerifyCode(grpc::ServerContext* context, const message::GetVerifyReq* request,
+	message::GetVerifyRsp* reply)
+{
+	// ΪspanGateServertraceparent
+	std::string traceparent;
+	auto& metadata = context->client_metadata();
+	auto iter = metadata.find("traceparent");
+	if (iter != metadata.end()) {
+		traceparent.assign(iter->second.data(), iter->second.size());
+	}
+	Span span = Tracer::Inst().StartRequest(traceparent, "fake VerifyService/GetVerifyCode");
+
+	_behavior.Sleep();
+	if (_behavior.NextError()) {
+		span.SetError("injected failure");
+		return grpc::Status(grpc::StatusCode::UNAVAILABLE, "injected failure");
+	}
+
+	reply->set_email(request->email());
+	std::string key = CODEPREFIX + request->email();
+	std::string code;
+	if (!RedisMgr::GetInstance()->Get(key, code)) {
+		code = NewCode();
+		if (!RedisMgr::GetInstance()->SetExpire(key, code, 600)) {
+			reply->set_error(VerifyRedisErr);
+			return grpc::Status::OK;
+		}
+	}
+	LOG_DEBUG("fake verify code of ", request->email(), " is ", code);
+	reply->set_error(VerifySuccess);
+	return grpc::Status::OK;
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include <grpcpp/grpcpp.h>
+#include "message.grpc.pb.h"
+#include "FakeBackend.h"
+#include <memory>
+
+// ڵVerifyServiceNodeдVerifyServer
+// server.jsһRedisȡcode_<email>ʱ4λ֤벢600룬ʼ
+// FakeBehaviorgRPCĹ߳еȴһʱ䣬ʷUNAVAILABLE
+class FakeVerifyServer final : public message::VerifyService::Service
+{
+public:
+	explicit FakeVerifyServer(const FakeBehavior& behavior);
+	~FakeVerifyServer();
+
+	// addresshost:portʧʱ׳쳣
+	void Start(const std::string& address);
+	void Stop();
+
+	grpc::Status GetVerifyCode(grpc::ServerContext* context, const message::GetVerifyReq* request,
+		message::GetVerifyRsp* reply) override;
+
+private:
+	FakeBehavior _behavior;
+	std::unique_ptr<grpc::Server> _server;
+};
@@ -0,0 +1,43 @@
+#include "GrpcChannelSet.h"
+#include "ConfigMgr.h"
+
+namespace {
+	int ReadInt(const std::string& section, const std::string& key, int default_value) {
+		std::string value = ConfigMgr::Inst()[section][key];
+		if (value.empty()) {
+			return default_value;
+		}
+		return atoi(value.c_str());
+	}
+}
+
+GrpcChannelOptions GrpcChannelOptions::Load(const std::string& section)
+{
+	auto& cfg = ConfigMgr::Inst();
+	GrpcChannelOptions options;
+	options.target = cfg[section]["Host"] + ":" + cfg[section]["Port"];
+	int channels = ReadInt(section, "Channels", 1);
+	options.channels = channels > 0 ? static_cast<std::size_t>(channels) : 1;
+	options.keepalive_time_s = ReadInt(section, "KeepAliveTime", 0);
+	options.keepalive_timeout_s = ReadInt(section, "KeepAliveTimeout", 20);
+	options.max_message_size = ReadInt(section, "MaxMessageSize", 0);
+	return options;
+}
+
+grpc::ChannelArguments GrpcChannelOptions::Arguments() const
+{
+	grpc::ChannelArguments args;
+	args.SetInt(GRPC_ARG_USE_LOCAL_SUBCHANNEL_POOL, 1);
+	if (keepalive_time_s > 0) {
+		args.SetInt(GRPC_ARG_KEEPALIVE_TIME_MS, keepalive_time_s * 1000);
+		args.SetInt(GRPC_ARG_KEEPALIVE_TIMEOUT_MS, keepalive_timeout_s * 1000);
+		// û;ʱҲӲᱻм豸ĶϿ
+		args.SetInt(GRPC_ARG_KEEPALIVE_PERMIT_WITHOUT_CALLS, 1);
+		args.SetInt(GRPC_ARG_HTTP2_MAX_PINGS_WITHOUT_DATA, 0);
+	}
+	if (max_message_size > 0) {
+		args.SetMaxReceiveMessageSize(max_message_size);
+		args.SetMaxSendMessageSize(max_message_size);
+	}
+	return args;
+}
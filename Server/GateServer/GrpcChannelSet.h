@@ -0,0 +1,72 @@
+#pragma once
+#include <grpcpp/grpcpp.h>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+// gRPCͻͨãconfig.iniĳζȡ[VarifyServer]
+//   HostPort          ַ
+//   Channels            ͨÿͨһTCP+HTTP/2ӣĬ1
+//   KeepAliveTime       ʱHTTP/2 PINGļ룩0ͣ
+//                       Ĭ5ֻһPINGǰҪͬʱſ˵
+//   KeepAliveTimeout    ȴPINGӦĳʱ룩ʱرĬ20
+//   MaxMessageSize      շϢֽ0gRPCĬֵ
+// ÿϵ󲢷ɷͨ棬ͻֻ̯ܿͨ
+struct GrpcChannelOptions {
+	std::string target;
+	std::size_t channels = 1;
+	int keepalive_time_s = 0;
+	int keepalive_timeout_s = 20;
+	int max_message_size = 0;
+
+	static GrpcChannelOptions Load(const std::string& section);
+	// תɴͨõĲÿͨʹԼͨأͬͨṲһ
+	grpc::ChannelArguments Arguments() const;
+};
+
+// gRPCͨÿͨһstubstub̰߳ȫģʱҪ͹黹
+// ͬһͨϵĵHTTP/2·áNextԭӼѯѡû
+template <typename Service>
+class GrpcChannelSet
+{
+public:
+	using Stub = typename Service::Stub;
+
+	explicit GrpcChannelSet(const GrpcChannelOptions& options) {
+		grpc::ChannelArguments args = options.Arguments();
+		std::size_t count = options.channels > 0 ? options.channels : 1;
+		for (std::size_t i = 0; i < count; ++i) {
+			auto channel = grpc::CreateCustomChannel(options.target, grpc::InsecureChannelCredentials(), args);
+			_stubs.push_back(Service::NewStub(channel));
+			_channels.push_back(std::move(channel));
+		}
+	}
+	GrpcChannelSet(const GrpcChannelSet&) = delete;
+	GrpcChannelSet& operator=(const GrpcChannelSet&) = delete;
+
+	Stub& Next() {
+		std::size_t index = _next.fetch_add(1, std::memory_order_relaxed) % _stubs.size();
+		return *_stubs[index];
+	}
+
+	std::size_t Size() const {
+		return _channels.size();
+	}
+
+	// READY״̬ͨᴥ
+	std::size_t Ready() const {
+		std::size_t ready = 0;
+		for (const auto& channel : _channels) {
+			if (channel->GetState(false) == GRPC_CHANNEL_READY) {
+				++ready;
+			}
+		}
+		return ready;
+	}
+
+private:
+	std::vector<std::shared_ptr<grpc::Channel>> _channels;
+	std::vector<std::unique_ptr<Stub>> _stubs;
+	std::atomic<std::size_t> _next{ 0 };
+};
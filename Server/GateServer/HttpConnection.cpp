@@ -1,209 +1,459 @@
 #include "HttpConnection.h"
 #include "LogicSystem.h"
+#include "JsonBody.h"
 
 //HttpConnection::HttpConnection(tcp::socket socket)
 //    : _socket(std::move(socket)) {
 //}
 
-HttpConnection::HttpConnection(boost::asio::io_context & ioc)
-    : _socket(ioc)
+namespace {
+    // Ӽָ꣬ӹ
+    struct HttpMetrics {
+        Gauge& active = Metrics::Inst().GetGauge("gate_http_active_connections", "HttpConnections currently serving a socket");
+        Counter& bytes_in = Metrics::Inst().GetCounter("gate_http_received_bytes_total", "HTTP request bytes parsed");
+        Counter& bytes_out = Metrics::Inst().GetCounter("gate_http_sent_bytes_total", "HTTP response bytes written");
+    };
+
+    HttpMetrics& GetHttpMetrics() {
+        static HttpMetrics metrics;
+        return metrics;
+    }
+
+    // ׶γʱãֻڵһʹʱconfig.iniȡ
+    struct HttpConfig {
+        bool keep_alive = true;                         // Ƿ
+        std::size_t max_requests = 100;                 // ദ
+        std::chrono::seconds header_timeout{ 10 };      // Ӷһͷʱޣֹͷ
+        std::chrono::seconds idle_timeout{ 15 };        // ϵȴһͷʱ
+        std::chrono::seconds body_timeout{ 30 };        // ʱ
+        std::chrono::seconds handle_timeout{ 60 };      // ҵʱ
+        std::chrono::seconds write_timeout{ 30 };       // дӦʱ
+        std::uint64_t max_body_size = 64 * 1024;        // ֽظ413
+    };
+
+    void ReadSeconds(SectionInfo& section, const std::string& key, std::chrono::seconds& value) {
+        std::string str = section[key];
+        if (!str.empty()) {
+            value = std::chrono::seconds(atoi(str.c_str()));
+        }
+    }
+
+    const HttpConfig& GetHttpConfig() {
+        static const HttpConfig config = []() {
+            HttpConfig cfg;
+            auto section = ConfigMgr::Inst()["GateServer"];
+            std::string keep_alive = section["KeepAlive"];
+            std::string max_requests = section["MaxKeepAliveRequests"];
+            if (!keep_alive.empty()) {
+                cfg.keep_alive = (keep_alive == "true" || keep_alive == "1");
+            }
+            if (!max_requests.empty()) {
+                cfg.max_requests = static_cast<std::size_t>(atoi(max_requests.c_str()));
+            }
+            ReadSeconds(section, "HeaderTimeout", cfg.header_timeout);
+            ReadSeconds(section, "KeepAliveTimeout", cfg.idle_timeout);
+            ReadSeconds(section, "BodyTimeout", cfg.body_timeout);
+            ReadSeconds(section, "HandleTimeout", cfg.handle_timeout);
+            ReadSeconds(section, "WriteTimeout", cfg.write_timeout);
+            // һ쳣ʱĬֵ
+            std::string max_body_size = section["MaxBodySize"];
+            std::uint64_t body_size = std::strtoull(max_body_size.c_str(), nullptr, 10);
+            if (body_size > 0) {
+                cfg.max_body_size = body_size;
+            }
+            return cfg;
+        }();
+        return config;
+    }
+}
+
+HttpConnection::HttpConnection(boost::asio::io_context & ioc, TimerWheel& wheel, IOContextLoad* load)
+    : _socket(ioc), _wheel(wheel), _load(load)
 {
 
 }
 
 void HttpConnection::Start()
+{
+    _active = true;
+    GetHttpMetrics().active.Add(1);
+    if (_load) {
+        _load->connections.fetch_add(1, std::memory_order_relaxed);
+    }
+    ReadRequest();
+}
+
+void HttpConnection::ReadRequest()
 {
     auto self = shared_from_this();
-    http::async_read(
-        _socket, 
+    // ÿʹµparserһͷʱ㣬֮󰴳ӿгʱ
+    _parser.emplace();
+    _parser->body_limit(GetHttpConfig().max_body_size);
+    CheckDeadline(_request_count == 0 ? DeadlinePhase::Header : DeadlinePhase::Idle);
+
+    // ˮ_bufferпѾһݣȽЩ
+    http::async_read_header(
+        _socket,
         _buffer,        // TCPֽ
-        _request,       // httpģŵ_request
+        *_parser,       // ֻͷ
         [self](beast::error_code ec, std::size_t bytes_transferred) {
+            LoopMonitor::Busy busy("http read");
+            AllocProfile::Scope alloc_scope(&self->_alloc);
             try {
                 if (ec) {
-                    std::cout << "http read err is " << ec.what() << std::endl;
+                    self->OnReadError(ec);
+                    return;
+                }
+
+                self->_request_start = std::chrono::steady_clock::now();
+                if (self->_load) {
+                    self->_in_flight = true;
+                    self->_load->requests.fetch_add(1, std::memory_order_relaxed);
+                }
+                GetHttpMetrics().bytes_in.Inc(bytes_transferred);
+                self->StartTrace();
+                if (self->_parser->is_done()) {
+                    self->OnRequestRead();
+                    return;
+                }
+                self->ReadBody();
+            }
+            catch (std::exception& exp) {
+                LOG_ERROR("exception is ", exp.what());
+            }
+        }
+    );
+}
+
+void HttpConnection::StartTrace()
+{
+    // ͷtraceparentʱεtrace_id򰴲ʾǷ½
+    const auto& header = _parser->get();
+    auto iter = header.find("traceparent");
+    std::string_view value;
+    if (iter != header.end()) {
+        value = std::string_view(iter->value().data(), iter->value().size());
+    }
+    auto target = header.target();
+    _span = Tracer::Inst().StartRequest(value, std::string_view(target.data(), target.size()));
+    if (_span.Recording()) {
+        _span.SetAttribute("http.method", std::string_view(header.method_string().data(), header.method_string().size()));
+        _span.SetAttribute("http.target", std::string_view(target.data(), target.size()));
+    }
+}
+
+void HttpConnection::ReadBody()
+{
+    auto self = shared_from_this();
+    _phase_span = Span(_span.Context(), "read body");
+    CheckDeadline(DeadlinePhase::Body);
+    // Content-LengthһԤJSONҪֽڣʱݿ
+    auto content_length = _parser->content_length();
+    if (content_length && JsonBody::Padding() > 0) {
+        _parser->get().body().reserve(static_cast<std::size_t>(*content_length) + JsonBody::Padding());
+    }
+    http::async_read(
+        _socket,
+        _buffer,
+        *_parser,       // httpģŵ_parser
+        [self](beast::error_code ec, std::size_t bytes_transferred) {
+            LoopMonitor::Busy busy("http read body");
+            AllocProfile::Scope alloc_scope(&self->_alloc);
+            try {
+                if (ec) {
+                    self->OnReadError(ec);
                     return;
                 }
 
                 //
-                boost::ignore_unused(bytes_transferred);    // httpҪճƱδʹñľ档
-                self->HandleReq();                          // 
-                self->CheckDeadline();                      // ʱ
+                GetHttpMetrics().bytes_in.Inc(bytes_transferred);
+                self->OnRequestRead();
             }
             catch (std::exception& exp) {
-                std::cout << "exception is " << exp.what() << std::endl;
+                LOG_ERROR("exception is ", exp.what());
             }
         }
     );
 }
 
-//char תΪ16
-unsigned char ToHex(unsigned char x)
+void HttpConnection::OnRequestRead()
 {
-    return  x > 9 ? x + 55 : x + 48;
+    _phase_span.End();
+    _request = _parser->release();
+    ++_request_count;
+    CheckDeadline(DeadlinePhase::Handle);           // ʱ
+    HandleReq();                                    // 
+}
+
+void HttpConnection::OnReadError(beast::error_code ec)
+{
+    // 峬ޣظ413ر
+    if (ec == http::error::body_limit) {
+        _response.version(_parser->get().version());
+        _response.keep_alive(false);
+        _response.result(http::status::payload_too_large);
+        _response.set(http::field::server, "GateServer");
+        _response.set(http::field::content_type, "text/plain");
+        _response.body() = "request body too large\r\n";
+        _request_start = std::chrono::steady_clock::now();
+        WriteResponse();
+        return;
+    }
+
+    // ԶرճӲ
+    if (ec != http::error::end_of_stream) {
+        LOG_WARN("http read err is ", ec);
+    }
+    if (_span.Recording()) {
+        _span.SetError(ec.message());
+    }
+    _deadline.Cancel();
+    _socket.shutdown(tcp::socket::shutdown_send, ec);
 }
 
-unsigned char FromHex(unsigned char x)
+void HttpConnection::ResetForNextRequest()
 {
-    unsigned char y;
-    if (x >= 'A' && x <= 'Z') y = x - 'A' + 10;
-    else if (x >= 'a' && x <= 'z') y = x - 'a' + 10;
-    else if (x >= '0' && x <= '9') y = x - '0';
-    else assert(0);
-    return y;
+    _request = {};
+    // bodyַѷһӦֱд
+    std::string body = std::move(_response.body());
+    body.clear();
+    _response = {};
+    _response.body() = std::move(body);
+    _get_params.Clear();
+    _path_params.clear();
+    _response_deferred = false;
+    _route_metrics = nullptr;
+    _span = Span();
+    _phase_span = Span();
 }
 
-// url
-std::string UrlEncode(const std::string& str)
+void HttpConnection::Recycle()
 {
-    std::string strTemp = "";
-    size_t length = str.length();
-    for (size_t i = 0; i < length; i++)
-    {
-        //жǷֺĸ
-        if (isalnum((unsigned char)str[i]) ||
-            (str[i] == '-') ||
-            (str[i] == '_') ||
-            (str[i] == '.') ||
-            (str[i] == '~'))
-            strTemp += str[i];
-        else if (str[i] == ' ') //Ϊַ
-            strTemp += "+";
-        else
-        {
-            //ַҪǰ%Ҹλ͵λֱתΪ16
-            strTemp += '%';
-            strTemp += ToHex((unsigned char)str[i] >> 4);
-            strTemp += ToHex((unsigned char)str[i] & 0x0F);
+    beast::error_code ec;
+    _socket.close(ec);
+    _deadline.Cancel();
+    _buffer.clear();
+    _parser.reset();
+    ResetForNextRequest();
+    _alloc.Clear();
+    _request_count = 0;
+    EndRequestLoad();
+    if (_active) {
+        _active = false;
+        GetHttpMetrics().active.Sub(1);
+        if (_load) {
+            _load->connections.fetch_sub(1, std::memory_order_relaxed);
         }
     }
-    return strTemp;
 }
 
-// url
-std::string UrlDecode(const std::string& str)
+void HttpConnection::EndRequestLoad()
 {
-    std::string strTemp = "";
-    size_t length = str.length();
-    for (size_t i = 0; i < length; i++)
-    {
-        //ԭ+Ϊ
-        if (str[i] == '+') strTemp += ' ';
-        //%ַ16תΪcharƴ
-        else if (str[i] == '%')
-        {
-            assert(i + 2 < length);
-            unsigned char high = FromHex((unsigned char)str[++i]);
-            unsigned char low = FromHex((unsigned char)str[++i]);
-            strTemp += high * 16 + low;
-        }
-        else strTemp += str[i];
+    if (_in_flight) {
+        _in_flight = false;
+        _load->requests.fetch_sub(1, std::memory_order_relaxed);
     }
-    return strTemp;
 }
 
-void HttpConnection::PreParseGetParam() {
+bool HttpConnection::PreParseGetParam() {
     // ȡ URI  get_test?key1=value&key2=value2
     auto uri = _request.target();
     // ҲѯַĿʼλã '?' λã  
     auto query_pos = uri.find('?');
     if (query_pos == std::string::npos) {
-        _get_url = uri;
-        return;
+        return true;
     }
 
-    _get_url = uri.substr(0, query_pos);
-    std::string query_string = uri.substr(query_pos + 1);
-    std::string key;
-    std::string value;
-    size_t pos = 0;
-    while ((pos = query_string.find('&')) != std::string::npos) {
-        auto pair = query_string.substr(0, pos);
-        size_t eq_pos = pair.find('=');
-        if (eq_pos != std::string::npos) {
-            key = UrlDecode(pair.substr(0, eq_pos)); //  url_decode URL  
-            value = UrlDecode(pair.substr(eq_pos + 1));
-            _get_params[key] = value;
-        }
-        query_string.erase(0, pos + 1);
-    }
-    // һԣû & ָ  
-    if (!query_string.empty()) {
-        size_t eq_pos = query_string.find('=');
-        if (eq_pos != std::string::npos) {
-            key = UrlDecode(query_string.substr(0, eq_pos));
-            value = UrlDecode(query_string.substr(eq_pos + 1));
-            _get_params[key] = value;
-        }
-    }
+    // ֱָеtargetȡֵʱŰ
+    std::string_view query_string(uri.data() + query_pos + 1, uri.size() - query_pos - 1);
+    return _get_params.Parse(query_string);
 }
 
 void HttpConnection::HandleReq() {
     //ð汾
     _response.version(_request.version());
-    //Ϊ
-    _response.keep_alive(false); 
-
-    // get󣬽·ɺhttpconnectionݸlogicsystem
-    if (_request.method() == http::verb::get) {
-        PreParseGetParam();
-        bool success = LogicSystem::GetInstance()->HandleGet(_get_url, shared_from_this());
-        
-        if (!success) {
-            _response.result(http::status::not_found);
-            _response.set(http::field::content_type, "text/plain");
-            beast::ostream(_response.body()) << "url not found\r\n";
-            WriteResponse();
-            return;
-        }
+    //ͻҪӡδʱ
+    const auto& cfg = GetHttpConfig();
+    _response.keep_alive(cfg.keep_alive && _request.keep_alive()
+        && _request_count < cfg.max_requests);
 
-        _response.result(http::status::ok);
-        _response.set(http::field::server, "GateServer");
+    _response.result(http::status::ok);
+    _response.set(http::field::server, "GateServer");
+
+    // ·ֻƥ·ֱ֣еtarget
+    auto target = _request.target();
+    std::string_view path(target.data(), target.size());
+    path = path.substr(0, path.find('?'));
+
+    // getȽѯת岻Ϸʱظ400
+    if (_request.method() == http::verb::get && !PreParseGetParam()) {
+        _response.result(http::status::bad_request);
+        _response.set(http::field::content_type, "text/plain");
+        _response.body() = "bad query string\r\n";
         WriteResponse();
         return;
     }
 
-    if (_request.method() == http::verb::post) {
-        bool success = LogicSystem::GetInstance()->HandlePost(_request.target(), shared_from_this());
-        if (!success) {
-            _response.result(http::status::not_found);
-            _response.set(http::field::content_type, "text/plain");
-            beast::ostream(_response.body()) << "url not found\r\n";
-            WriteResponse();
-            return;
-        }
+    // ·ɺhttpconnectionݸlogicsystem
+    auto status = LogicSystem::GetInstance()->Dispatch(_request.method(), path, shared_from_this());
+    if (status == RouteStatus::NotFound) {
+        _response.result(http::status::not_found);
+        _response.set(http::field::content_type, "text/plain");
+        _response.body() = "url not found\r\n";
+        WriteResponse();
+        return;
+    }
 
-        _response.result(http::status::ok);
-        _response.set(http::field::server, "GateServer");
+    if (status == RouteStatus::MethodNotAllowed) {
+        _response.result(http::status::method_not_allowed);
+        _response.set(http::field::content_type, "text/plain");
+        _response.body() = "method not allowed\r\n";
         WriteResponse();
         return;
     }
+
+    // ý˺̳߳أɺӦ
+    if (_response_deferred) {
+        return;
+    }
+    WriteResponse();
+}
+
+std::string_view HttpConnection::GetPathParam(std::string_view name) const {
+    for (const auto& param : _path_params) {
+        if (param.name == name) {
+            return param.value;
+        }
+    }
+    return {};
+}
+
+void HttpConnection::FinishResponse() {
+    _response_deferred = false;
+    WriteResponse();
+}
+
+void HttpConnection::RunAsyncHandler(net::awaitable<void> handler) {
+    _response_deferred = true;
+    auto self = shared_from_this();
+    auto done = [self](std::exception_ptr error) {
+        LoopMonitor::Busy busy("coroutine done");
+        AllocProfile::Scope alloc_scope(&self->_alloc);
+        if (error) {
+            try {
+                std::rethrow_exception(error);
+            }
+            catch (BackendBusyError&) {
+                self->ServiceUnavailable();
+            }
+            catch (std::exception& exp) {
+                LOG_ERROR("async handler exception is ", exp.what());
+                self->InternalError();
+            }
+            catch (...) {
+                LOG_ERROR("async handler unknown exception");
+                self->InternalError();
+            }
+        }
+        self->FinishResponse();
+    };
+    if constexpr (AllocProfile::Enabled()) {
+        net::co_spawn(_socket.get_executor(), RunAttributed(std::move(handler)), std::move(done));
+    }
+    else {
+        net::co_spawn(_socket.get_executor(), std::move(handler), std::move(done));
+    }
+}
+
+net::awaitable<void> HttpConnection::RunAttributed(net::awaitable<void> handler) {
+    // co_spawnͶٿʼִЭִ̣ʱκλصScopeڣ
+    // Э̹ʱBackendExecutor::Runͣ¼ָʱٽ
+    AllocProfile::Scope alloc_scope(&_alloc);
+    co_await std::move(handler);
+}
+
+void HttpConnection::ServiceUnavailable() {
+    // ѾдݣΪ503
+    _response_deferred = false;
+    _response.result(http::status::service_unavailable);
+    _response.set(http::field::content_type, "text/plain");
+    _response.body() = "server busy\r\n";
+}
+
+void HttpConnection::InternalError() {
+    // 503һѾдݣǰJSONΪ500
+    _response.result(http::status::internal_server_error);
+    _response.set(http::field::content_type, "text/plain");
+    _response.body() = "internal server error\r\n";
 }
 
 void HttpConnection::WriteResponse() {
     auto self = shared_from_this();
     _response.content_length(_response.body().size());      // bodyֽ
+    if (_span.Recording()) {
+        // ѱεtrace_id߿ͻˣ㰴span
+        _response.set("traceparent", _span.Context().ToTraceParent());
+        _phase_span = Span(_span.Context(), "write response");
+    }
+    CheckDeadline(DeadlinePhase::Write);
     http::async_write(
         _socket,
         _response,
-        [self](beast::error_code ec, std::size_t)
+        [self](beast::error_code ec, std::size_t bytes_transferred)
         {
+            LoopMonitor::Busy busy("http write");
+            AllocProfile::Scope alloc_scope(&self->_alloc);
+            self->_deadline.Cancel();                               // ȡʱ
+            GetHttpMetrics().bytes_out.Inc(bytes_transferred);
+            auto& route = self->_route_metrics ? *self->_route_metrics : LogicSystem::UnmatchedMetrics();
+            route.Record(self->_response.result_int(), std::chrono::steady_clock::now() - self->_request_start);
+            if constexpr (AllocProfile::Enabled()) {
+                // ֮λͶһͷķ㵽һ
+                route.alloc.Record(self->_alloc, route.name);
+                self->_alloc.Clear();
+            }
+            self->EndTrace(ec);
+            self->EndRequestLoad();
+            if (!ec && self->_response.keep_alive()) {
+                // ӣsocketͻһ
+                self->ResetForNextRequest();
+                self->ReadRequest();
+                return;
+            }
             self->_socket.shutdown(tcp::socket::shutdown_send, ec); // صͶˣԷ
-            self->deadline_.cancel();                               // ȡʱ
         });
 }
 
-void HttpConnection::CheckDeadline() {
-    auto self = shared_from_this();
+void HttpConnection::EndTrace(beast::error_code ec) {
+    if (!_span.Recording()) {
+        return;
+    }
+    _phase_span.End();
+    _span.SetAttribute("http.status_code", static_cast<std::int64_t>(_response.result_int()));
+    if (ec) {
+        _span.SetError(ec.message());
+    }
+    else if (_response.result_int() >= 500) {
+        _span.SetError(std::string(_response.reason()));
+    }
+    _span.End();
+}
 
-    deadline_.async_wait(
-        [self](beast::error_code ec)
-        {
-            if (!ec)
-            {
-                // Close socket to cancel any outstanding operation.
-                self->_socket.close(ec);
-            }
+void HttpConnection::CheckDeadline(DeadlinePhase phase) {
+    const auto& cfg = GetHttpConfig();
+    std::chrono::seconds timeout = cfg.handle_timeout;
+    switch (phase) {
+    case DeadlinePhase::Header: timeout = cfg.header_timeout; break;
+    case DeadlinePhase::Idle:   timeout = cfg.idle_timeout; break;
+    case DeadlinePhase::Body:   timeout = cfg.body_timeout; break;
+    case DeadlinePhase::Handle: timeout = cfg.handle_timeout; break;
+    case DeadlinePhase::Write:  timeout = cfg.write_timeout; break;
+    }
+
+    // ʱǶӶʱԶժصпֱʹthis
+    _wheel.Arm(_deadline, timeout, [this]() {
+        // Close socket to cancel any outstanding operation.
+        beast::error_code ec;
+        _socket.close(ec);
         });
 }
-
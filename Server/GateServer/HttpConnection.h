@@ -1,23 +1,73 @@
 #pragma once
 #include "const.h"
+#include "TimerWheel.h"
+#include "BackendExecutor.h"
+#include "Router.h"
+#include "QueryString.h"
+#include "LoopMonitor.h"
+#include "Tracer.h"
+#include "AllocProfile.h"
+#include "IOContextSelector.h"
+#include <optional>
+
+struct RouteMetrics;
 
 class HttpConnection : public std::enable_shared_from_this<HttpConnection>
 {
     friend class LogicSystem;
+    friend class HttpConnectionPool;
+    friend struct MicroBenchAccess;     // GateMicroBenchֱͷַ
 public:
     // HttpConnection(tcp::socket socket);
-    HttpConnection(boost::asio::io_context& ioc);
+    // loadΪio_contextĸؼΪʱͳƣ΢׼ֱӹӣ
+    HttpConnection(boost::asio::io_context& ioc, TimerWheel& wheel, IOContextLoad* load = nullptr);
     void Start();
     tcp::socket& GetSocket()
     {
         return _socket;
     }
 
+    // ڱӵio߳Э̴Э̽Ӧ
+    // Э׳BackendBusyErrorʱظ503쳣ظ500
+    void RunAsyncHandler(net::awaitable<void> handler);
+
+    // ·{name}Ӧ·ʱؿ
+    std::string_view GetPathParam(std::string_view name) const;
+
+    // ·ģڴ֮´˵õspan
+    const TraceContext& GetTraceContext() const
+    {
+        return _span.Context();
+    }
+
 private:
-    void CheckDeadline();       // ⳬʱʱ
+    // Ľ׶Σÿ׶иԵĳʱʱ
+    enum class DeadlinePhase {
+        Header,     // Ӷһͷ
+        Idle,       // ӵȴȡһͷ
+        Body,       // 
+        Handle,     // ҵ
+        Write,      // дӦ
+    };
+
+    void ReadRequest();         // ȡһ󣬳ѭ
+    void ReadBody();            // ȡ
+    void OnRequestRead();       // һ
+    void OnReadError(beast::error_code ec);
+    void StartTrace();          // ͷʼspan
+    void EndTrace(beast::error_code ec);    // Ӧдspan
+    void CheckDeadline(DeadlinePhase phase);    // ׶μⳬʱʱ
     void WriteResponse();       // Ӧ
+    void FinishResponse();      // ˵ɺio߳Ӧ
+    void ServiceUnavailable();  // ̳߳رͣΪ503Ӧ
+    void InternalError();       // ׳쳣Ϊ500Ӧ
     void HandleReq();           // 
-    void PreParseGetParam();    // urlΪֵ
+    bool PreParseGetParam();    // urlеĲѯΪֵԣʽ󷵻false
+    void ResetForNextRequest(); // ӸǰһεӦ
+    void Recycle();             // Żضǰرsocket״̬
+    void EndRequestLoad();      // Ӧдӹرգ;мȥ
+    // GATE_ALLOC_PROFILEʱװЭ̴һΣһι֮ǰķҲǵ
+    net::awaitable<void> RunAttributed(net::awaitable<void> handler);
 
 
 
@@ -26,19 +76,46 @@ private:
     //  The buffer for performing reads.
     beast::flat_buffer  _buffer{ 8192 };
 
-    // dynamic̬ The request message.
-    http::request<http::dynamic_body> _request;
+    // ֽ׶ζȡÿ¹
+    std::optional<http::request_parser<http::string_body>> _parser;
 
-    // Ӧͻ The response message.
-    http::response<http::dynamic_body> _response;
+    // bodyַJsonBodyֱ The request message.
+    http::request<http::string_body> _request;
 
-    // ʱжǷʱ The timer for putting a deadline on connection processing.
-    net::steady_timer deadline_{
-        _socket.get_executor(), std::chrono::seconds(60)    // ʮʱ
-    }; // ʹ{}бʼԷֹ()ϵ
+    // ӦͻˣbodyַJsonWriterֱд The response message.
+    http::response<http::string_body> _response;
 
-    // urlΪֵ
-    std::string _get_url;
-    std::unordered_map<std::string, std::string> _get_params;
-};
+    // io̵߳ʱֺ͹ĳʱʱ The timer for putting a deadline on connection processing.
+    TimerWheel& _wheel;
+    TimerWheel::Timer _deadline;
 
+    // urlΪֵԣָ_requesttarget
+    QueryParams _get_params;
+
+    // ·ƥ·ָ_requesttarget
+    PathParams _path_params;
+
+    // ǰѾõ޺رճ
+    std::size_t _request_count = 0;
+
+    // ѽӦƳٵ˵֮
+    bool _response_deferred = false;
+
+    // ƥ䵽·ָ꣬δƥʱΪգǵunmatched
+    RouteMetrics* _route_metrics = nullptr;
+    // ͷʱ䣬ʱ
+    std::chrono::steady_clock::time_point _request_start;
+    // ѼԾ
+    bool _active = false;
+    // io_contextĸؼStartRecycleʱ£;ڶͷӦдʱ
+    IOContextLoad* _load;
+    // Ѽ;
+    bool _in_flight = false;
+
+    // ķspan͵ǰ׶Σ塢дӦ𣩵spanδʱ¼
+    Span _span;
+    Span _phase_span;
+
+    // ڸصЭ̺ͺеĶѷ䣬Ӧдǵ·
+    AllocProfile::Tally _alloc;
+};
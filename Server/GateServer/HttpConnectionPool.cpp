@@ -0,0 +1,77 @@
+#include "HttpConnectionPool.h"
+#include "HttpConnection.h"
+
+HttpConnectionPool::HttpConnectionPool(boost::asio::io_context& ioc, TimerWheel& wheel, IOContextLoad& load, std::size_t max_idle)
+	: _ioc(ioc), _wheel(wheel), _load(load), _max_idle(max_idle), _blocks(std::make_shared<RecycleBlocks>()), _b_stop(false)
+{
+	_idle.reserve(max_idle);
+}
+
+HttpConnectionPool::~HttpConnectionPool()
+{
+	Shutdown();
+}
+
+std::shared_ptr<HttpConnection> HttpConnectionPool::Acquire()
+{
+	HttpConnection* con = nullptr;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (!_idle.empty()) {
+			con = _idle.back();
+			_idle.pop_back();
+		}
+	}
+	if (con == nullptr) {
+		con = new HttpConnection(_ioc, _wheel, &_load);
+	}
+	return std::shared_ptr<HttpConnection>(con, Recycler{ shared_from_this() },
+		RecycleAllocator<HttpConnection>(_blocks));
+}
+
+std::size_t HttpConnectionPool::IdleCount()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _idle.size();
+}
+
+void HttpConnectionPool::Shutdown()
+{
+	std::vector<HttpConnection*> idle;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_b_stop = true;
+		idle.swap(_idle);
+	}
+	for (auto* con : idle) {
+		delete con;
+	}
+}
+
+void HttpConnectionPool::Recycler::operator()(HttpConnection* con) const
+{
+	// һÿں߳ͷţòҪصԼiọ߳
+	// ʱڵֻʱֵ߳ժ
+	auto target = pool;
+	{
+		std::lock_guard<std::mutex> lock(target->_mutex);
+		if (target->_b_stop) {
+			delete con;
+			return;
+		}
+	}
+	net::dispatch(target->_ioc, [target, con]() {
+		target->Release(con);
+		});
+}
+
+void HttpConnectionPool::Release(HttpConnection* con)
+{
+	con->Recycle();
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (_b_stop || _idle.size() >= _max_idle) {
+		delete con;
+		return;
+	}
+	_idle.push_back(con);
+}
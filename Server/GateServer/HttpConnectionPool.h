@@ -0,0 +1,101 @@
+#pragma once
+#include "const.h"
+#include "TimerWheel.h"
+#include "IOContextSelector.h"
+
+class HttpConnection;
+
+// ̶СĿпHttpConnectionPoolУֻͬһshared_ptrƿʹ
+// ƿӳ֮ͷţԷйãʱͷŻĿ
+struct RecycleBlocks {
+	std::mutex mutex;
+	std::vector<void*> blocks;
+
+	~RecycleBlocks() {
+		for (void* block : blocks) {
+			::operator delete(block);
+		}
+	}
+};
+
+// HttpConnectionأÿio_contextһ
+// ӹرպͷţӦŻؿsocketʱڵ㶼ã
+// shared_ptrĿƿҲӿ䣬ȶʱӲڴ
+class HttpConnectionPool : public std::enable_shared_from_this<HttpConnectionPool>
+{
+public:
+	// loadio_contextĸؼе¼;
+	HttpConnectionPool(boost::asio::io_context& ioc, TimerWheel& wheel, IOContextLoad& load, std::size_t max_idle);
+	~HttpConnectionPool();
+	HttpConnectionPool(const HttpConnectionPool&) = delete;
+	HttpConnectionPool& operator=(const HttpConnectionPool&) = delete;
+
+	// ȡһӣûʱ½һͷʱԶ
+	std::shared_ptr<HttpConnection> Acquire();
+	// ǰ
+	std::size_t IdleCount();
+	// io_contextֹͣãͷſӣ֮黹ֱ
+	void Shutdown();
+
+private:
+	// shared_ptrɾӷŻسӶ
+	struct Recycler {
+		std::shared_ptr<HttpConnectionPool> pool;
+		void operator()(HttpConnection* con) const;
+	};
+
+	void Release(HttpConnection* con);
+
+	boost::asio::io_context& _ioc;
+	TimerWheel& _wheel;
+	IOContextLoad& _load;
+	std::size_t _max_idle;
+	std::mutex _mutex;
+	std::vector<HttpConnection*> _idle;
+	std::shared_ptr<RecycleBlocks> _blocks;		// ӵshared_ptrƿ
+	bool _b_stop;
+};
+
+// RecycleBlocksķshared_ptrƿ
+// ÿӳһֻio_context̺߳ͽӵ֮߳侺
+template <typename T>
+class RecycleAllocator {
+public:
+	typedef T value_type;
+
+	explicit RecycleAllocator(std::shared_ptr<RecycleBlocks> blocks) : _blocks(std::move(blocks)) {}
+	template <typename U>
+	RecycleAllocator(const RecycleAllocator<U>& other) : _blocks(other._blocks) {}
+
+	T* allocate(std::size_t n) {
+		if (n == 1) {
+			std::lock_guard<std::mutex> lock(_blocks->mutex);
+			if (!_blocks->blocks.empty()) {
+				void* block = _blocks->blocks.back();
+				_blocks->blocks.pop_back();
+				return static_cast<T*>(block);
+			}
+		}
+		return static_cast<T*>(::operator new(n * sizeof(T)));
+	}
+
+	void deallocate(T* p, std::size_t n) {
+		if (n == 1) {
+			std::lock_guard<std::mutex> lock(_blocks->mutex);
+			_blocks->blocks.push_back(p);
+			return;
+		}
+		::operator delete(p);
+	}
+
+	template <typename U>
+	bool operator==(const RecycleAllocator<U>& other) const { return _blocks == other._blocks; }
+	template <typename U>
+	bool operator!=(const RecycleAllocator<U>& other) const { return _blocks != other._blocks; }
+
+private:
+	template <typename U>
+	friend class RecycleAllocator;
+
+	std::shared_ptr<RecycleBlocks> _blocks;
+};
@@ -0,0 +1,97 @@
+#include "IOContextSelector.h"
+#include "Logger.h"
+#include <chrono>
+#include <thread>
+
+namespace {
+	// p2cõÿ߳һxorshift״̬
+	std::uint64_t NextRandom() {
+		thread_local std::uint64_t state = (static_cast<std::uint64_t>(
+			std::chrono::steady_clock::now().time_since_epoch().count())
+			^ (std::hash<std::thread::id>()(std::this_thread::get_id()) * 0x9E3779B97F4A7C15ull)) | 1;
+		state ^= state << 13;
+		state ^= state >> 7;
+		state ^= state << 17;
+		return state;
+	}
+}
+
+IOContextSelector::IOContextSelector(std::size_t size, IOContextPolicy policy)
+	: _size(size == 0 ? 1 : size), _policy(policy), _loads(new IOContextLoad[size == 0 ? 1 : size])
+{
+}
+
+std::size_t IOContextSelector::Select()
+{
+	if (_size == 1) {
+		return 0;
+	}
+	switch (_policy) {
+	case IOContextPolicy::LeastConn:
+		return SelectLeastConn();
+	case IOContextPolicy::PowerOfTwo:
+		return SelectPowerOfTwo();
+	default:
+		return _next.fetch_add(1, std::memory_order_relaxed) % _size;
+	}
+}
+
+std::size_t IOContextSelector::SelectLeastConn()
+{
+	// ѯλÿʼɨ裬ͬʱ˻Ϊѯѡе0
+	std::size_t start = _next.fetch_add(1, std::memory_order_relaxed) % _size;
+	std::size_t best = start;
+	auto best_connections = _loads[start].connections.load(std::memory_order_relaxed);
+	for (std::size_t i = 1; i < _size; ++i) {
+		std::size_t index = (start + i) % _size;
+		auto connections = _loads[index].connections.load(std::memory_order_relaxed);
+		if (connections < best_connections) {
+			best = index;
+			best_connections = connections;
+		}
+	}
+	return best;
+}
+
+std::size_t IOContextSelector::SelectPowerOfTwo()
+{
+	auto random = NextRandom();
+	std::size_t a = static_cast<std::size_t>(random % _size);
+	std::size_t b = static_cast<std::size_t>((random >> 32) % (_size - 1));
+	if (b >= a) {
+		++b;
+	}
+	auto requests_a = _loads[a].requests.load(std::memory_order_relaxed);
+	auto requests_b = _loads[b].requests.load(std::memory_order_relaxed);
+	if (requests_a != requests_b) {
+		return requests_a < requests_b ? a : b;
+	}
+	return _loads[a].connections.load(std::memory_order_relaxed) <= _loads[b].connections.load(std::memory_order_relaxed) ? a : b;
+}
+
+IOContextPolicy IOContextSelector::ParsePolicy(const std::string& name)
+{
+	if (name.empty() || name == "round_robin") {
+		return IOContextPolicy::RoundRobin;
+	}
+	if (name == "least_conn") {
+		return IOContextPolicy::LeastConn;
+	}
+	if (name == "p2c") {
+		return IOContextPolicy::PowerOfTwo;
+	}
+	LOG_WARN("unknown IOContextPolicy ", name, ", use round_robin");
+	return IOContextPolicy::RoundRobin;
+}
+
+const char* IOContextSelector::PolicyName(IOContextPolicy policy)
+{
+	switch (policy) {
+	case IOContextPolicy::LeastConn:
+		return "least_conn";
+	case IOContextPolicy::PowerOfTwo:
+		return "p2c";
+	default:
+		return "round_robin";
+	}
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// һio_contextϵĸأio߳ϵӸ£acceptor̶߳ȡ
+struct alignas(64) IOContextLoad {
+	std::atomic<std::int64_t> connections{ 0 };	// ڷsocket
+	std::atomic<std::int64_t> requests{ 0 };	// ;ͷӦд꣬ȴ˵ʱ
+};
+
+// ӷ䵽ĸio_contextĲԣconfig.ini[GateServer] IOContextPolicy
+//   round_robin  ԭӼѯĬ
+//   least_conn   Ծٵģͬʱѯλȡһ
+//   p2c          ȡѡ;ٵģͬʱѡٵģpower of two choices
+// asioṩio_contextŶеhandlerp2c;߳δɵĹ
+enum class IOContextPolicy {
+	RoundRobin,
+	LeastConn,
+	PowerOfTwo,
+};
+
+class IOContextSelector
+{
+public:
+	IOContextSelector(std::size_t size, IOContextPolicy policy);
+	IOContextSelector(const IOContextSelector&) = delete;
+	IOContextSelector& operator=(const IOContextSelector&) = delete;
+
+	// ѡһ±꣬ڶ߳ͬʱ
+	std::size_t Select();
+	IOContextLoad& Load(std::size_t index) { return _loads[index]; }
+	std::size_t Size() const { return _size; }
+	IOContextPolicy Policy() const { return _policy; }
+
+	// ʶְround_robin־
+	static IOContextPolicy ParsePolicy(const std::string& name);
+	static const char* PolicyName(IOContextPolicy policy);
+
+private:
+	std::size_t SelectLeastConn();
+	std::size_t SelectPowerOfTwo();
+
+	std::size_t _size;
+	IOContextPolicy _policy;
+	std::unique_ptr<IOContextLoad[]> _loads;
+	alignas(64) std::atomic<std::size_t> _next{ 0 };
+};
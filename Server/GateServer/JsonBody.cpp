@@ -0,0 +1,182 @@
+#include "JsonBody.h"
+
+#ifdef GATE_USE_SIMDJSON
+#include <simdjson.h>
+#else
+#include <json/json.h>
+#include <memory>
+#endif
+
+void JsonBody::AddField(std::string_view key, std::string_view value)
+{
+	Field field;
+	field.key_pos = _storage.size();
+	field.key_len = key.size();
+	_storage.append(key);
+	field.value_pos = _storage.size();
+	field.value_len = value.size();
+	_storage.append(value);
+	_fields.push_back(field);
+}
+
+const JsonBody::Field* JsonBody::Find(std::string_view key) const
+{
+	// ֶκ٣ӺǰԲң֤ظkeyȡһ
+	for (auto it = _fields.rbegin(); it != _fields.rend(); ++it) {
+		if (std::string_view(_storage.data() + it->key_pos, it->key_len) == key) {
+			return &*it;
+		}
+	}
+	return nullptr;
+}
+
+std::string_view JsonBody::Get(std::string_view key) const
+{
+	auto field = Find(key);
+	if (field == nullptr) {
+		return {};
+	}
+	return std::string_view(_storage.data() + field->value_pos, field->value_len);
+}
+
+bool JsonBody::Has(std::string_view key) const
+{
+	return Find(key) != nullptr;
+}
+
+#ifdef GATE_USE_SIMDJSON
+
+const char* JsonBody::Backend()
+{
+	return "simdjson";
+}
+
+std::size_t JsonBody::Padding()
+{
+	return simdjson::SIMDJSON_PADDING;
+}
+
+bool JsonBody::Parse(std::string& body)
+{
+	_storage.clear();
+	_fields.clear();
+	_storage.reserve(body.size());
+
+	// parserڲɸãÿio߳һ
+	thread_local simdjson::ondemand::parser parser;
+
+	// on-demandҪݺSIMDJSON_PADDINGֽڿɶContent-Lengthڶ֮ǰѾԤ
+	// chunkedݣ´һ
+	if (body.capacity() < body.size() + simdjson::SIMDJSON_PADDING) {
+		body.reserve(body.size() + simdjson::SIMDJSON_PADDING);
+	}
+	simdjson::padded_string_view json(body.data(), body.size(), body.capacity());
+
+	simdjson::ondemand::document doc;
+	if (parser.iterate(json).get(doc)) {
+		return false;
+	}
+	simdjson::ondemand::object object;
+	if (doc.get_object().get(object)) {
+		return false;
+	}
+
+	for (auto result : object) {
+		simdjson::ondemand::field field;
+		if (result.get(field)) {
+			return false;
+		}
+		std::string_view key;
+		if (field.unescaped_key().get(key)) {
+			return false;
+		}
+		// keyָparserĻȡvalue֮ǰȴ
+		std::string key_copy(key);
+
+		simdjson::ondemand::value value = field.value();
+		simdjson::ondemand::json_type type;
+		if (value.type().get(type)) {
+			return false;
+		}
+
+		std::string_view text;
+		switch (type) {
+		case simdjson::ondemand::json_type::string:
+			if (value.get_string().get(text)) {
+				return false;
+			}
+			break;
+		case simdjson::ondemand::json_type::number:
+		case simdjson::ondemand::json_type::boolean:
+			text = value.raw_json_token();
+			while (!text.empty() && (text.back() == ' ' || text.back() == '\t'
+				|| text.back() == '\r' || text.back() == '\n')) {
+				text.remove_suffix(1);
+			}
+			break;
+		default:
+			// Ƕ׶nullȡһֶʱԶ
+			continue;
+		}
+		AddField(key_copy, text);
+	}
+
+	// ֮
+	return doc.at_end();
+}
+
+#else
+
+const char* JsonBody::Backend()
+{
+	return "jsoncpp";
+}
+
+std::size_t JsonBody::Padding()
+{
+	return 0;
+}
+
+bool JsonBody::Parse(std::string& body)
+{
+	_storage.clear();
+	_fields.clear();
+	_storage.reserve(body.size());
+
+	// CharReaderɸãÿio߳һ
+	thread_local std::unique_ptr<Json::CharReader> reader = []() {
+		Json::CharReaderBuilder builder;
+		builder["collectComments"] = false;
+		builder["stackLimit"] = 64;
+		return std::unique_ptr<Json::CharReader>(builder.newCharReader());
+	}();
+
+	Json::Value root;
+	std::string errs;
+	if (!reader->parse(body.data(), body.data() + body.size(), &root, &errs)) {
+		return false;
+	}
+	if (!root.isObject()) {
+		return false;
+	}
+
+	for (auto it = root.begin(); it != root.end(); ++it) {
+		const Json::Value& value = *it;
+		const char* key_begin = nullptr;
+		const char* key_end = nullptr;
+		key_begin = it.memberName(&key_end);
+		std::string_view key(key_begin, key_end - key_begin);
+		if (value.isString()) {
+			const char* begin = nullptr;
+			const char* end = nullptr;
+			value.getString(&begin, &end);
+			AddField(key, std::string_view(begin, end - begin));
+		}
+		else if (value.isNumeric() || value.isBool()) {
+			AddField(key, value.asString());
+		}
+	}
+	return true;
+}
+
+#endif
@@ -0,0 +1,46 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// JSON㣺ֻ󣬰ѱֶһȡ֮keyȡֵDOM
+// ڱʱѡ
+//   ĬʹjsoncppCharReader
+//   GATE_USE_SIMDJSONsimdjsonʱʹsimdjsonon-demandʵʣ
+//   ûм볣湹ǰҪԼ벢һGateMicroBenchJson
+// СHttpConnectionbody_limitƣconfig.iniеMaxBodySize
+class JsonBody
+{
+public:
+	JsonBody() = default;
+
+	// 壬㲻Ƕʽʱfalse
+	// simdjsonҪbodyݶPadding()ֽڣʱݣһ壩޸
+	bool Parse(std::string& body);
+
+	// ҪԤֽjsoncppΪ0֮ǰContent-LengthԤParseͲ
+	static std::size_t Padding();
+
+	// ȡֶεֵֶβʱؿմֺͲֵԭģǶ׵Ķnull
+	// ظkeyһΪ׼ֵJsonBodyһParse֮ǰЧ
+	std::string_view Get(std::string_view key) const;
+	bool Has(std::string_view key) const;
+
+	// ǰʹõĺ
+	static const char* Backend();
+
+private:
+	struct Field {
+		std::size_t key_pos;
+		std::size_t key_len;
+		std::size_t value_pos;
+		std::size_t value_len;
+	};
+
+	void AddField(std::string_view key, std::string_view value);
+	const Field* Find(std::string_view key) const;
+
+	std::string _storage;			// keyvalueδ
+	std::vector<Field> _fields;
+};
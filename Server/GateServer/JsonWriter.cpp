@@ -0,0 +1,173 @@
+#include "JsonWriter.h"
+#include "const.h"
+#include <cassert>
+#include <charconv>
+
+JsonWriter::JsonWriter(std::string& out) : _out(out)
+{
+
+}
+
+void JsonWriter::BeforeValue()
+{
+	if (_after_key) {
+		_after_key = false;
+		return;
+	}
+	if (_depth > 0) {
+		if (_need_comma[_depth - 1]) {
+			_out.push_back(',');
+		}
+		_need_comma[_depth - 1] = true;
+	}
+}
+
+JsonWriter& JsonWriter::BeginObject()
+{
+	BeforeValue();
+	_out.push_back('{');
+	// Ƕɵ÷ĴMAX_DEPTHǱ̴
+	assert(_depth < MAX_DEPTH);
+	_need_comma[_depth] = false;
+	++_depth;
+	return *this;
+}
+
+JsonWriter& JsonWriter::EndObject()
+{
+	--_depth;
+	_out.push_back('}');
+	return *this;
+}
+
+JsonWriter& JsonWriter::BeginArray()
+{
+	BeforeValue();
+	_out.push_back('[');
+	assert(_depth < MAX_DEPTH);
+	_need_comma[_depth] = false;
+	++_depth;
+	return *this;
+}
+
+JsonWriter& JsonWriter::EndArray()
+{
+	--_depth;
+	_out.push_back(']');
+	return *this;
+}
+
+JsonWriter& JsonWriter::Key(std::string_view key)
+{
+	BeforeValue();
+	_out.push_back('"');
+	AppendEscaped(_out, key);
+	_out.append("\":", 2);
+	_after_key = true;
+	return *this;
+}
+
+JsonWriter& JsonWriter::String(std::string_view value)
+{
+	BeforeValue();
+	_out.push_back('"');
+	AppendEscaped(_out, value);
+	_out.push_back('"');
+	return *this;
+}
+
+JsonWriter& JsonWriter::Int(std::int64_t value)
+{
+	BeforeValue();
+	char buf[24];
+	auto result = std::to_chars(buf, buf + sizeof(buf), value);
+	_out.append(buf, result.ptr - buf);
+	return *this;
+}
+
+JsonWriter& JsonWriter::Bool(bool value)
+{
+	BeforeValue();
+	if (value) {
+		_out.append("true", 4);
+	}
+	else {
+		_out.append("false", 5);
+	}
+	return *this;
+}
+
+JsonWriter& JsonWriter::Null()
+{
+	BeforeValue();
+	_out.append("null", 4);
+	return *this;
+}
+
+void JsonWriter::AppendEscaped(std::string& out, std::string_view value)
+{
+	static const char HEX[] = "0123456789abcdef";
+	// ҪתƬ׷
+	std::size_t run_begin = 0;
+	for (std::size_t i = 0; i < value.size(); ++i) {
+		unsigned char c = static_cast<unsigned char>(value[i]);
+		if (c >= 0x20 && c != '"' && c != '\\') {
+			continue;
+		}
+		out.append(value.data() + run_begin, i - run_begin);
+		run_begin = i + 1;
+		switch (c) {
+		case '"':  out.append("\\\"", 2); break;
+		case '\\': out.append("\\\\", 2); break;
+		case '\n': out.append("\\n", 2); break;
+		case '\r': out.append("\\r", 2); break;
+		case '\t': out.append("\\t", 2); break;
+		case '\b': out.append("\\b", 2); break;
+		case '\f': out.append("\\f", 2); break;
+		default: {
+			char buf[6] = { '\\', 'u', '0', '0', HEX[c >> 4], HEX[c & 0x0F] };
+			out.append(buf, sizeof(buf));
+			break;
+		}
+		}
+	}
+	out.append(value.data() + run_begin, value.size() - run_begin);
+}
+
+namespace JsonTemplates {
+	namespace {
+		// ԤSuccessUidInvalidдӦ
+		struct ErrorTable {
+			std::string success;
+			std::string errors[ErrorCodes::UidInvalid - ErrorCodes::Error_Json + 1];
+
+			ErrorTable() {
+				JsonWriter(success).BeginObject().Field("error", 0).EndObject();
+				for (int code = ErrorCodes::Error_Json; code <= ErrorCodes::UidInvalid; ++code) {
+					JsonWriter(errors[code - ErrorCodes::Error_Json]).BeginObject().Field("error", code).EndObject();
+				}
+			}
+		};
+
+		const ErrorTable& GetErrorTable() {
+			static const ErrorTable table;
+			return table;
+		}
+	}
+
+	std::string_view Error(int code)
+	{
+		const auto& table = GetErrorTable();
+		if (code == ErrorCodes::Success) {
+			return table.success;
+		}
+		if (code >= ErrorCodes::Error_Json && code <= ErrorCodes::UidInvalid) {
+			return table.errors[code - ErrorCodes::Error_Json];
+		}
+		// Ĵÿɣֲ߳̾
+		thread_local std::string buf;
+		buf.clear();
+		JsonWriter(buf).BeginObject().Field("error", code).EndObject();
+		return buf;
+	}
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// JSONдֱ׷ӵӦbodyַУJson::ValueҲûͻ
+// ÷JsonWriter(body).BeginObject().Field("error", 0).Field("email", email).EndObject();
+class JsonWriter
+{
+public:
+	explicit JsonWriter(std::string& out);
+
+	JsonWriter& BeginObject();
+	JsonWriter& EndObject();
+	JsonWriter& BeginArray();
+	JsonWriter& EndArray();
+
+	JsonWriter& Key(std::string_view key);
+	JsonWriter& String(std::string_view value);
+	JsonWriter& Int(std::int64_t value);
+	JsonWriter& Bool(bool value);
+	JsonWriter& Null();
+
+	// Key + ֵ
+	JsonWriter& Field(std::string_view key, std::string_view value) { return Key(key).String(value); }
+	JsonWriter& Field(std::string_view key, const char* value) { return Key(key).String(value); }
+	JsonWriter& Field(std::string_view key, const std::string& value) { return Key(key).String(value); }
+	JsonWriter& Field(std::string_view key, int value) { return Key(key).Int(value); }
+	JsonWriter& Field(std::string_view key, std::int64_t value) { return Key(key).Int(value); }
+	JsonWriter& Field(std::string_view key, bool value) { return Key(key).Bool(value); }
+
+	// ׷תַݣߵţ
+	static void AppendEscaped(std::string& out, std::string_view value);
+
+private:
+	void BeforeValue();
+
+	static constexpr int MAX_DEPTH = 32;
+	std::string& _out;
+	int _depth = 0;
+	bool _need_comma[MAX_DEPTH] = {};	// ÿһǷѾдԪ
+	bool _after_key = false;			// дkeyֵҪ
+};
+
+// ̶ʽӦԤֽڣ{"error":1001}
+namespace JsonTemplates {
+	// ֻerrorֶεӦErrorCodesΧڵֱӷԤɵַ
+	std::string_view Error(int code);
+}
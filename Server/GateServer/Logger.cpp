@@ -0,0 +1,365 @@
+#include "Logger.h"
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <ctime>
+
+LogRing::LogRing(std::size_t capacity)
+	: _data(new char[capacity]), _mask(capacity - 1)
+{
+
+}
+
+void LogRing::CopyIn(std::uint64_t pos, const char* data, std::size_t len)
+{
+	std::size_t offset = static_cast<std::size_t>(pos & _mask);
+	std::size_t first = std::min(len, _mask + 1 - offset);
+	std::memcpy(_data.get() + offset, data, first);
+	std::memcpy(_data.get(), data + first, len - first);
+}
+
+void LogRing::CopyOut(std::uint64_t pos, char* data, std::size_t len) const
+{
+	std::size_t offset = static_cast<std::size_t>(pos & _mask);
+	std::size_t first = std::min(len, _mask + 1 - offset);
+	std::memcpy(data, _data.get() + offset, first);
+	std::memcpy(data + first, _data.get(), len - first);
+}
+
+bool LogRing::Push(const char* data, std::size_t len)
+{
+	std::uint64_t head = _head.load(std::memory_order_relaxed);
+	if (head + len - _cached_tail > _mask + 1) {
+		_cached_tail = _tail.load(std::memory_order_acquire);
+		if (head + len - _cached_tail > _mask + 1) {
+			_dropped.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+	}
+	CopyIn(head, data, len);
+	_head.store(head + len, std::memory_order_release);
+	return true;
+}
+
+bool LogRing::CrossedHalf()
+{
+	std::uint64_t half = (_mask + 1) / 2;
+	std::uint64_t head = _head.load(std::memory_order_relaxed);
+	// λֻƫɣûгһһûг
+	if (head - _cached_tail <= half) {
+		_above_half = false;
+		return false;
+	}
+	_cached_tail = _tail.load(std::memory_order_acquire);
+	bool above = head - _cached_tail > half;
+	bool crossed = above && !_above_half;
+	_above_half = above;
+	return crossed;
+}
+
+bool LogRing::Pop(std::string& out)
+{
+	std::uint64_t tail = _tail.load(std::memory_order_relaxed);
+	std::uint64_t head = _head.load(std::memory_order_acquire);
+	if (tail == head) {
+		return false;
+	}
+	std::uint32_t len = 0;
+	CopyOut(tail, reinterpret_cast<char*>(&len), sizeof(len));
+	out.resize(len);
+	CopyOut(tail, out.data(), len);
+	_tail.store(tail + len, std::memory_order_release);
+	return true;
+}
+
+LogRecord::LogRecord(LogLevel level)
+{
+	_buf[4] = static_cast<char>(level);
+	std::int64_t now = std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::system_clock::now().time_since_epoch()).count();
+	std::memcpy(_buf + 5, &now, sizeof(now));
+}
+
+void LogRecord::Put(const void* data, std::size_t len)
+{
+	if (_size + len > MAX_SIZE) {
+		_full = true;
+		return;
+	}
+	std::memcpy(_buf + _size, data, len);
+	_size += len;
+}
+
+void LogRecord::Append(std::string_view value)
+{
+	// ǩ + 4ֽڳ + ݣ¼޵Ĳֽض
+	constexpr std::size_t overhead = 1 + sizeof(std::uint32_t);
+	if (_full || _size + overhead >= MAX_SIZE) {
+		_full = true;
+		return;
+	}
+	std::size_t room = MAX_SIZE - _size - overhead;
+	if (value.size() > room) {
+		value = value.substr(0, room);
+		_full = true;
+	}
+	std::uint32_t len = static_cast<std::uint32_t>(value.size());
+	PutTag(TagString);
+	Put(&len, sizeof(len));
+	Put(value.data(), value.size());
+}
+
+void LogRecord::Append(const boost::system::error_code& ec)
+{
+	// ֻ¼ʹֵmessage()̨߳ȡ
+	const boost::system::error_category* category = &ec.category();
+	int value = ec.value();
+	PutTag(TagErrorCode);
+	Put(&category, sizeof(category));
+	Put(&value, sizeof(value));
+}
+
+const char* LogRecord::Data()
+{
+	std::uint32_t len = static_cast<std::uint32_t>(_size);
+	std::memcpy(_buf, &len, sizeof(len));
+	return _buf;
+}
+
+std::int64_t LogRecord::Timestamp(const char* data)
+{
+	std::int64_t ts = 0;
+	std::memcpy(&ts, data + 5, sizeof(ts));
+	return ts;
+}
+
+namespace {
+	const char* LevelName(int level) {
+		switch (level) {
+		case GATE_LOG_LEVEL_DEBUG: return "DEBUG";
+		case GATE_LOG_LEVEL_INFO:  return "INFO ";
+		case GATE_LOG_LEVEL_WARN:  return "WARN ";
+		default:                   return "ERROR";
+		}
+	}
+
+	template<typename T>
+	T Read(const char*& p) {
+		T value;
+		std::memcpy(&value, p, sizeof(T));
+		p += sizeof(T);
+		return value;
+	}
+
+	template<typename T>
+	void AppendNumber(std::string& out, T value) {
+		char buf[32];
+		auto result = std::to_chars(buf, buf + sizeof(buf), value);
+		out.append(buf, result.ptr - buf);
+	}
+}
+
+void LogRecord::Format(const char* data, std::size_t len, unsigned thread_index, std::string& out)
+{
+	// ʱ  [߳] 
+	std::int64_t ts = Timestamp(data);
+	std::time_t seconds = static_cast<std::time_t>(ts / 1000000);
+	std::tm tm_time;
+#ifdef _WIN32
+	localtime_s(&tm_time, &seconds);
+#else
+	localtime_r(&seconds, &tm_time);
+#endif
+	char time_buf[40];
+	std::size_t time_len = std::strftime(time_buf, sizeof(time_buf), "%Y-%m-%d %H:%M:%S", &tm_time);
+	std::snprintf(time_buf + time_len, sizeof(time_buf) - time_len, ".%06d ", static_cast<int>(ts % 1000000));
+	out.append(time_buf);
+	out.append(LevelName(static_cast<unsigned char>(data[4])));
+	out.append(" [");
+	AppendNumber(out, thread_index);
+	out.append("] ");
+
+	const char* p = data + HEADER_SIZE;
+	const char* end = data + len;
+	while (p < end) {
+		Tag tag = static_cast<Tag>(*p++);
+		switch (tag) {
+		case TagInt:
+			AppendNumber(out, Read<std::int64_t>(p));
+			break;
+		case TagUInt:
+			AppendNumber(out, Read<std::uint64_t>(p));
+			break;
+		case TagDouble: {
+			char buf[32];
+			std::snprintf(buf, sizeof(buf), "%g", Read<double>(p));
+			out.append(buf);
+			break;
+		}
+		case TagBool:
+			out.append(Read<char>(p) ? "1" : "0");
+			break;
+		case TagChar:
+			out.push_back(Read<char>(p));
+			break;
+		case TagString: {
+			auto size = Read<std::uint32_t>(p);
+			out.append(p, size);
+			p += size;
+			break;
+		}
+		case TagPointer: {
+			char buf[32];
+			std::snprintf(buf, sizeof(buf), "%p", Read<const void*>(p));
+			out.append(buf);
+			break;
+		}
+		case TagErrorCode: {
+			auto category = Read<const boost::system::error_category*>(p);
+			int value = Read<int>(p);
+			out.append(category->message(value));
+			break;
+		}
+		default:
+			p = end;
+			break;
+		}
+	}
+	out.push_back('\n');
+}
+
+Logger& Logger::Inst()
+{
+	static Logger* logger = new Logger();
+	return *logger;
+}
+
+Logger::Logger()
+{
+	_flusher = std::thread([this]() {
+		Run();
+		});
+}
+
+LogRing& Logger::LocalRing()
+{
+	// ߳˳ʱرԼĻ̨߳ȡʣ־Ƴ
+	struct Holder {
+		std::shared_ptr<LogRing> ring;
+		~Holder() {
+			if (ring) {
+				ring->Close();
+			}
+		}
+	};
+	thread_local Holder holder;
+	if (!holder.ring) {
+		holder.ring = std::make_shared<LogRing>(RING_CAPACITY);
+		std::lock_guard<std::mutex> lock(_mutex);
+		holder.ring->SetThreadIndex(_next_thread_index++);
+		_rings.push_back(holder.ring);
+	}
+	return *holder.ring;
+}
+
+void Logger::Submit(LogRecord& record)
+{
+	const char* data = record.Data();
+	if (_stop.load(std::memory_order_acquire)) {
+		// ֹ̨߳ͣͬ
+		std::string line;
+		LogRecord::Format(data, record.Size(), 0, line);
+		std::fwrite(line.data(), 1, line.size(), stdout);
+		std::fflush(stdout);
+		return;
+	}
+	auto& ring = LocalRing();
+	ring.Push(data, record.Size());
+	// չʱǰһκ̨̣߳ȶʱˢ
+	if (ring.CrossedHalf()) {
+		_cond.notify_one();
+	}
+}
+
+void Logger::Run()
+{
+	while (!_stop.load(std::memory_order_acquire)) {
+		if (!Drain()) {
+			std::unique_lock<std::mutex> lock(_mutex);
+			_cond.wait_for(lock, std::chrono::milliseconds(10));
+		}
+	}
+	// ֹͣǰʣ־ȡ
+	while (Drain()) {
+	}
+}
+
+bool Logger::Drain()
+{
+	std::vector<std::shared_ptr<LogRing>> rings;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		rings = _rings;
+	}
+
+	_batch.clear();
+	_lines.clear();
+	std::uint64_t dropped = 0;
+	std::vector<LogRing*> finished;
+	for (auto& ring : rings) {
+		bool closed = ring->Closed();
+		dropped += ring->TakeDropped();
+		while (ring->Pop(_record)) {
+			Line line;
+			line.timestamp = LogRecord::Timestamp(_record.data());
+			line.begin = _batch.size();
+			LogRecord::Format(_record.data(), _record.size(), ring->ThreadIndex(), _batch);
+			line.end = _batch.size();
+			_lines.push_back(line);
+		}
+		// رǰclosedΪ棬˵֮󲻻д룬Ƴ
+		if (closed) {
+			finished.push_back(ring.get());
+		}
+	}
+
+	if (!finished.empty()) {
+		std::lock_guard<std::mutex> lock(_mutex);
+		_rings.erase(std::remove_if(_rings.begin(), _rings.end(), [&finished](const std::shared_ptr<LogRing>& ring) {
+			return std::find(finished.begin(), finished.end(), ring.get()) != finished.end();
+			}), _rings.end());
+	}
+
+	if (_lines.empty() && dropped == 0) {
+		return false;
+	}
+
+	// ̵ͬ߳־ʱ
+	std::stable_sort(_lines.begin(), _lines.end(), [](const Line& a, const Line& b) {
+		return a.timestamp < b.timestamp;
+		});
+	_out.clear();
+	for (const auto& line : _lines) {
+		_out.append(_batch, line.begin, line.end - line.begin);
+	}
+	if (dropped > 0) {
+		_out.append("log ring full, dropped ");
+		AppendNumber(_out, dropped);
+		_out.append(" records\n");
+	}
+	std::fwrite(_out.data(), 1, _out.size(), stdout);
+	std::fflush(stdout);
+	return true;
+}
+
+void Logger::Stop()
+{
+	bool expected = false;
+	if (!_stop.compare_exchange_strong(expected, true)) {
+		return;
+	}
+	_cond.notify_all();
+	if (_flusher.joinable()) {
+		_flusher.join();
+	}
+}
@@ -0,0 +1,202 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include <boost/system/error_code.hpp>
+
+// ־𣬱ʱͨGATE_LOG_LEVELˣڸü־òκδ
+#define GATE_LOG_LEVEL_DEBUG 0
+#define GATE_LOG_LEVEL_INFO  1
+#define GATE_LOG_LEVEL_WARN  2
+#define GATE_LOG_LEVEL_ERROR 3
+#define GATE_LOG_LEVEL_OFF   4
+
+#ifndef GATE_LOG_LEVEL
+#define GATE_LOG_LEVEL GATE_LOG_LEVEL_INFO
+#endif
+
+enum class LogLevel : std::uint8_t {
+	Debug = GATE_LOG_LEVEL_DEBUG,
+	Info = GATE_LOG_LEVEL_INFO,
+	Warn = GATE_LOG_LEVEL_WARN,
+	Error = GATE_LOG_LEVEL_ERROR,
+};
+
+// ƴӣ÷std::cout << a << bһLOG_INFO("email is ", email);
+#define GATE_LOG(LEVEL, ...) \
+	do { \
+		if constexpr (static_cast<int>(LEVEL) >= GATE_LOG_LEVEL) { \
+			Logger::Inst().Write(LEVEL, __VA_ARGS__); \
+		} \
+	} while (0)
+
+#define LOG_DEBUG(...) GATE_LOG(LogLevel::Debug, __VA_ARGS__)
+#define LOG_INFO(...)  GATE_LOG(LogLevel::Info, __VA_ARGS__)
+#define LOG_WARN(...)  GATE_LOG(LogLevel::Warn, __VA_ARGS__)
+#define LOG_ERROR(...) GATE_LOG(LogLevel::Error, __VA_ARGS__)
+
+// ߵߵֽڻλд־̣߳Ą̊́ˢ߳
+class LogRing
+{
+public:
+	explicit LogRing(std::size_t capacity);
+
+	// дһļ¼ռ䲻ʱ
+	bool Push(const char* data, std::size_t len);
+	// ֽճһʱtrue䵽һ֮Żٴηtrue̵ֻ߳
+	bool CrossedHalf();
+	// ȡһ¼ŵoutУûм¼ʱfalse
+	bool Pop(std::string& out);
+
+	std::uint64_t TakeDropped() { return _dropped.exchange(0, std::memory_order_relaxed); }
+	void Close() { _closed.store(true, std::memory_order_release); }
+	bool Closed() const { return _closed.load(std::memory_order_acquire); }
+	unsigned ThreadIndex() const { return _thread_index; }
+	void SetThreadIndex(unsigned index) { _thread_index = index; }
+
+private:
+	void CopyIn(std::uint64_t pos, const char* data, std::size_t len);
+	void CopyOut(std::uint64_t pos, char* data, std::size_t len) const;
+
+	std::unique_ptr<char[]> _data;
+	std::size_t _mask;
+	unsigned _thread_index = 0;
+	std::atomic<bool> _closed{ false };
+	std::atomic<std::uint64_t> _dropped{ 0 };
+
+	alignas(64) std::atomic<std::uint64_t> _head{ 0 };	// дλ
+	std::uint64_t _cached_tail = 0;						// ߻λãٿ˶ȡ
+	bool _above_half = false;							// ϴοǷ񳬹һ
+	alignas(64) std::atomic<std::uint64_t> _tail{ 0 };	// ߶λ
+};
+
+// һ־¼ı룺ʹǩԭ룬תıȸʽ̨߳
+class LogRecord
+{
+public:
+	static constexpr std::size_t MAX_SIZE = 4096;			// ¼ޣַᱻض
+	static constexpr std::size_t HEADER_SIZE = 4 + 1 + 8;	//  +  + ʱ
+
+	enum Tag : std::uint8_t {
+		TagInt, TagUInt, TagDouble, TagBool, TagChar, TagString, TagPointer, TagErrorCode,
+	};
+
+	explicit LogRecord(LogLevel level);
+
+	void Append(std::string_view value);
+	void Append(const char* value) { Append(std::string_view(value ? value : "(null)")); }
+	void Append(const std::string& value) { Append(std::string_view(value)); }
+	void Append(char value) { PutTag(TagChar); Put(&value, 1); }
+	void Append(bool value) { PutTag(TagBool); char c = value ? 1 : 0; Put(&c, 1); }
+	void Append(const void* value) { PutTag(TagPointer); Put(&value, sizeof(value)); }
+	void Append(const boost::system::error_code& ec);
+
+	template<typename T>
+	void Append(const T& value) {
+		if constexpr (std::is_enum_v<T>) {
+			AppendInt(static_cast<long long>(value));
+		}
+		else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+			AppendInt(value);
+		}
+		else if constexpr (std::is_integral_v<T>) {
+			std::uint64_t v = value;
+			PutTag(TagUInt);
+			Put(&v, sizeof(v));
+		}
+		else if constexpr (std::is_floating_point_v<T>) {
+			double v = value;
+			PutTag(TagDouble);
+			Put(&v, sizeof(v));
+		}
+		else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+			Append(std::string_view(value));
+		}
+		else {
+			// ڵǰ̸߳ʽʧȥӳٸʽĺô
+			std::ostringstream oss;
+			oss << value;
+			Append(std::string_view(oss.str()));
+		}
+	}
+
+	// д볤Ⱥ󷵻ļ¼
+	const char* Data();
+	std::size_t Size() const { return _size; }
+
+	// ̨̰߳Ѽ¼һı
+	static void Format(const char* data, std::size_t len, unsigned thread_index, std::string& out);
+	static std::int64_t Timestamp(const char* data);
+
+private:
+	void AppendInt(long long value) {
+		std::int64_t v = value;
+		PutTag(TagInt);
+		Put(&v, sizeof(v));
+	}
+	void PutTag(Tag tag) { char c = static_cast<char>(tag); Put(&c, 1); }
+	void Put(const void* data, std::size_t len);
+
+	char _buf[MAX_SIZE];
+	std::size_t _size = HEADER_SIZE;
+	bool _full = false;
+};
+
+// 첽־ÿ߳дԼĻλ̶̨߳ռʽstdout
+// д־ֻмڴ濽Ҳϵͳãʱ֮󱨸涪
+// ̵ͬ߳־һˢڰʱ
+class Logger
+{
+public:
+	// ˳ǰmainStopʣ־ˢȥ
+	static Logger& Inst();
+
+	template<typename... Args>
+	void Write(LogLevel level, const Args&... args) {
+		LogRecord record(level);
+		(record.Append(args), ...);
+		Submit(record);
+	}
+
+	// ֹ̨̲ͣ߳ˢʣ־֮־ֱͬ
+	void Stop();
+
+private:
+	Logger();
+	Logger(const Logger&) = delete;
+	Logger& operator=(const Logger&) = delete;
+
+	void Submit(LogRecord& record);
+	LogRing& LocalRing();
+	void Run();
+	bool Drain();
+
+	static constexpr std::size_t RING_CAPACITY = 1 << 18;
+
+	std::mutex _mutex;									// _rings̵ֻ߳һд־ʱע
+	std::vector<std::shared_ptr<LogRing>> _rings;
+	unsigned _next_thread_index = 0;
+	std::condition_variable _cond;
+	std::atomic<bool> _stop{ false };
+	std::thread _flusher;
+
+	std::string _record;								// ֻں̨߳ʹ
+	std::string _out;
+	struct Line {
+		std::int64_t timestamp;
+		std::size_t begin;
+		std::size_t end;
+	};
+	std::vector<Line> _lines;
+	std::string _batch;
+};
@@ -3,136 +3,232 @@
 #include "VerifyGrpcClient.h"
 #include "RedisMgr.h"
 #include "MysqlMgr.h"
+#include "JsonWriter.h"
+#include "JsonBody.h"
+#include "Tracer.h"
+
+RouteMetrics::RouteMetrics(const std::string& route, const std::string& method)
+    : name(method.empty() ? route : method + " " + route)
+    , latency(Metrics::Inst().GetHistogram("gate_http_request_duration_seconds",
+        "HTTP request latency from request header read to response written",
+        "route=\"" + route + "\",method=\"" + method + "\""))
+{
+    for (int i = 0; i < 5; ++i) {
+        status[i] = &Metrics::Inst().GetCounter("gate_http_requests_total", "HTTP requests by route and status class",
+            "route=\"" + route + "\",method=\"" + method + "\",code=\"" + std::to_string(i + 1) + "xx\"");
+    }
+}
+
+void RouteMetrics::Record(unsigned code, std::chrono::steady_clock::duration elapsed) {
+    unsigned index = code / 100;
+    if (index < 1 || index > 5) {
+        index = 5;
+    }
+    status[index - 1]->Inc();
+    latency.RecordDuration(elapsed);
+}
+
+RouteMetrics& LogicSystem::UnmatchedMetrics() {
+    static RouteMetrics* metrics = new RouteMetrics("unmatched", "");
+    return *metrics;
+}
+
+void LogicSystem::Reg(http::verb method, const std::string& url, HttpHandler handler) {
+    _router.Add(method, url, _handlers.size());
+    _handlers.push_back(std::move(handler));
+    _route_metrics.push_back(std::make_unique<RouteMetrics>(url, std::string(http::to_string(method))));
+}
 
 void LogicSystem::RegGet(std::string url, HttpHandler handler) {
-    _get_handlers.insert(make_pair(url, handler));
+    Reg(http::verb::get, url, std::move(handler));
 }
 
 void LogicSystem::RegPost(std::string url, HttpHandler handler) {
-    _post_handlers.insert(make_pair(url, handler));
+    Reg(http::verb::post, url, std::move(handler));
+}
+
+void LogicSystem::RegGetAsync(std::string url, AsyncHttpHandler handler) {
+    Reg(http::verb::get, url, WrapAsync(std::move(handler)));
+}
+
+void LogicSystem::RegPostAsync(std::string url, AsyncHttpHandler handler) {
+    Reg(http::verb::post, url, WrapAsync(std::move(handler)));
+}
+
+HttpHandler LogicSystem::WrapAsync(AsyncHttpHandler handler) {
+    return [handler](std::shared_ptr<HttpConnection> connection) {
+        connection->RunAsyncHandler(handler(connection));
+    };
 }
 
 LogicSystem::LogicSystem() {
+    // HandlerMode = blocking时后端调用直接在io线程上同步执行，只用来和协程版本做对比测试
+    _blocking_handlers = ConfigMgr::Inst()["GateServer"]["HandlerMode"] == "blocking";
+
     RegGet("/get_test", [](std::shared_ptr<HttpConnection> connection) {
-        beast::ostream(connection->_response.body()) << "receive get_test req" << std::endl;
+        auto& body = connection->_response.body();
+        body.append("receive get_test req\n");
         int i = 0;
         for (auto& elem : connection->_get_params) {
             i++;
-            beast::ostream(connection->_response.body()) << "param" << i << " key is " << elem.first;
-            beast::ostream(connection->_response.body()) << ", " << " value is " << elem.second << std::endl;
+            body.append("param").append(std::to_string(i)).append(" key is ").append(elem.Key());
+            body.append(",  value is ").append(elem.Value()).append("\n");
         }
         });
 
-    RegPost("/get_verifycode", [](std::shared_ptr<HttpConnection> connection) {
-        auto body_str = boost::beast::buffers_to_string(connection->_request.body().data());
-        std::cout << "receive body is " << body_str << std::endl;
+    // Prometheus抓取接口
+    RegGet("/metrics", [](std::shared_ptr<HttpConnection> connection) {
+        connection->_response.set(http::field::content_type, "text/plain; version=0.0.4");
+        Metrics::Inst().Render(connection->_response.body());
+        });
+
+    // 堆分配统计：每个线程的累计值和每个路由的请求数、分配次数、字节数，
+    // 两次抓取的差值相除就是每个请求的分配；未定义GATE_ALLOC_PROFILE时enabled为false，计数都是0
+    RegGet("/admin/alloc", [this](std::shared_ptr<HttpConnection> connection) {
         connection->_response.set(http::field::content_type, "text/json");
-        Json::Value root;
-        Json::Reader reader;
-        Json::Value src_root;
-        bool parse_success = reader.parse(body_str, src_root);
-        if (!parse_success) {
-            std::cout << "Failed to parse JSON data!" << std::endl;
-            root["error"] = ErrorCodes::Error_Json;
-            std::string jsonstr = root.toStyledString();
-            beast::ostream(connection->_response.body()) << jsonstr;
-            return true;
+        JsonWriter writer(connection->_response.body());
+        writer.BeginObject()
+            .Field("enabled", AllocProfile::Enabled())
+            .Field("warn_per_request", static_cast<std::int64_t>(AllocProfile::WarnPerRequest()))
+            .Key("threads");
+        AllocProfile::RenderThreads(writer);
+        writer.Key("routes").BeginArray();
+        auto render = [&writer](const RouteMetrics& route) {
+            writer.BeginObject()
+                .Field("route", route.name)
+                .Field("requests", static_cast<std::int64_t>(route.alloc.requests.load()))
+                .Field("allocations", static_cast<std::int64_t>(route.alloc.allocations.load()))
+                .Field("bytes", static_cast<std::int64_t>(route.alloc.bytes.load()))
+                .Field("over_threshold", static_cast<std::int64_t>(route.alloc.over_threshold.load()))
+                .EndObject();
+        };
+        for (const auto& route : _route_metrics) {
+            render(*route);
         }
+        render(UnmatchedMetrics());
+        writer.EndArray().EndObject();
+        });
 
-        auto email = src_root["email"].asString();
-        GetVerifyRsp rsp = VerifyGrpcClient::GetInstance()->GetvarifyCode(email);
-        std::cout << "email is " << email << std::endl;
-        root["error"] = rsp.error();
-        root["email"] = src_root["email"];
-        std::string jsonstr = root.toStyledString();
-        beast::ostream(connection->_response.body()) << jsonstr;
-        return true;
+    RegPost("/get_verifycode", [this](std::shared_ptr<HttpConnection> connection) -> net::awaitable<void> {
+        auto& body_str = connection->_request.body();
+        LOG_DEBUG("receive body is ", body_str);
+        connection->_response.set(http::field::content_type, "text/json");
+        auto client = VerifyGrpcClient::GetInstance();
+        // VerifyServer熔断期间不解析请求，直接返回预生成的RPCFailed应答
+        if (client->BreakerOpen()) {
+            connection->_response.body() = JsonTemplates::Error(ErrorCodes::RPCFailed);
+            co_return;
+        }
+        JsonBody src_root;
+        if (!src_root.Parse(body_str)) {
+            LOG_INFO("Failed to parse JSON data!");
+            connection->_response.body() = JsonTemplates::Error(ErrorCodes::Error_Json);
+            co_return;
+        }
+
+        std::string email(src_root.Get("email"));
+        LOG_DEBUG("email is ", email);
+        // 异步gRPC调用，协程挂起期间io线程可以处理其他连接
+        GetVerifyRsp rsp;
+        if (_blocking_handlers) {
+            rsp = client->GetvarifyCode(email, connection->GetTraceContext());
+        }
+        else {
+            rsp = co_await client->AsyncGetvarifyCode(email, connection->GetTraceContext());
+        }
+        JsonWriter(connection->_response.body()).BeginObject()
+            .Field("error", rsp.error())
+            .Field("email", email)
+            .EndObject();
+        co_return;
         });
 
-    RegPost("/user_register", [](std::shared_ptr<HttpConnection> connection) {
-        auto body_str = boost::beast::buffers_to_string(connection->_request.body().data());
-        std::cout << "receive body is " << body_str << std::endl;
+    RegPost("/user_register", [this](std::shared_ptr<HttpConnection> connection) -> net::awaitable<void> {
+        auto& body_str = connection->_request.body();
+        LOG_DEBUG("receive body is ", body_str);
         connection->_response.set(http::field::content_type, "text/json");
-        Json::Value root;
-        Json::Reader reader;
-        Json::Value src_root;
-        bool parse_success = reader.parse(body_str, src_root);
-        if (!parse_success) {
-            std::cout << "Failed to parse JSON data!" << std::endl;
-            root["error"] = ErrorCodes::Error_Json;
-            std::string jsonstr = root.toStyledString();
-            beast::ostream(connection->_response.body()) << jsonstr;
-            return true;
+        JsonBody src_root;
+        if (!src_root.Parse(body_str)) {
+            LOG_INFO("Failed to parse JSON data!");
+            connection->_response.body() = JsonTemplates::Error(ErrorCodes::Error_Json);
+            co_return;
         }
 
 
-        auto email = src_root["email"].asString();
-        auto name = src_root["user"].asString();
-        auto pwd = src_root["passwd"].asString();
-        auto confirm = src_root["confirm"].asString();
+        std::string email(src_root.Get("email"));
+        std::string name(src_root.Get("user"));
+        std::string pwd(src_root.Get("passwd"));
+        std::string confirm(src_root.Get("confirm"));
 
         if (pwd != confirm) {
-            std::cout << "password err " << std::endl;
-            root["error"] = ErrorCodes::PasswdErr;
-            std::string jsonstr = root.toStyledString();
-            beast::ostream(connection->_response.body()) << jsonstr;
-            return true;
+            LOG_INFO("password err ");
+            connection->_response.body() = JsonTemplates::Error(ErrorCodes::PasswdErr);
+            co_return;
         }
 
-        //�Ȳ���redis��email��Ӧ����֤���Ƿ����
-        std::string  verify_code;
-        bool b_get_verify = RedisMgr::GetInstance()->Get(CODEPREFIX + src_root["email"].asString(), verify_code);
-        if (!b_get_verify) {
-            std::cout << " get verify code expired" << std::endl;
-            root["error"] = ErrorCodes::VerifyExpired;
-            std::string jsonstr = root.toStyledString();
-            beast::ostream(connection->_response.body()) << jsonstr;
-            return true;
+        //先查找redis中email对应的验证码是否合理
+        std::optional<std::string> verify_code;
+        if (_blocking_handlers) {
+            std::string value;
+            if (RedisMgr::GetInstance()->Get(CODEPREFIX + email, value)) {
+                verify_code = std::move(value);
+            }
         }
-        if (verify_code != src_root["verifycode"].asString()) {
-            std::cout << " verify code error" << std::endl;
-            root["error"] = ErrorCodes::VerifyCodeErr;
-            std::string jsonstr = root.toStyledString();
-            beast::ostream(connection->_response.body()) << jsonstr;
-            return true;
+        else {
+            verify_code = co_await RedisMgr::GetInstance()->AsyncGet(CODEPREFIX + email, connection->GetTraceContext());
+        }
+        if (!verify_code) {
+            LOG_INFO(" get verify code expired");
+            connection->_response.body() = JsonTemplates::Error(ErrorCodes::VerifyExpired);
+            co_return;
+        }
+        if (*verify_code != src_root.Get("verifycode")) {
+            LOG_INFO(" verify code error");
+            connection->_response.body() = JsonTemplates::Error(ErrorCodes::VerifyCodeErr);
+            co_return;
         }
 
         //查找数据库判断用户是否存在
-        int uid = MysqlMgr::GetInstance()->RegUser(name, email, pwd);
+        int uid = 0;
+        if (_blocking_handlers) {
+            uid = MysqlMgr::GetInstance()->RegUser(name, email, pwd);
+        }
+        else {
+            uid = co_await MysqlMgr::GetInstance()->AsyncRegUser(name, email, pwd, connection->GetTraceContext());
+        }
         if (uid == 0 || uid == -1) {
-            std::cout << " user or email exist" << std::endl;
-            root["error"] = ErrorCodes::UserExist;
-            std::string jsonstr = root.toStyledString();
-            beast::ostream(connection->_response.body()) << jsonstr;
-            return true;
+            LOG_INFO(" user or email exist");
+            connection->_response.body() = JsonTemplates::Error(ErrorCodes::UserExist);
+            co_return;
         }
-        root["error"] = 0;
-        root["uid"] = uid;
-        root["email"] = email;
-        root["user"] = name;
-        root["passwd"] = pwd;
-        root["confirm"] = confirm;
-        root["verifycode"] = src_root["verifycode"].asString();
-        std::string jsonstr = root.toStyledString();
-        beast::ostream(connection->_response.body()) << jsonstr;
-        return true;
+        JsonWriter(connection->_response.body()).BeginObject()
+            .Field("error", ErrorCodes::Success)
+            .Field("uid", uid)
+            .Field("email", email)
+            .Field("user", name)
+            .Field("passwd", pwd)
+            .Field("confirm", confirm)
+            .Field("verifycode", *verify_code)
+            .EndObject();
+        co_return;
         });
 }
 
-bool LogicSystem::HandleGet(std::string path, std::shared_ptr<HttpConnection> con) {
-    if (_get_handlers.find(path) == _get_handlers.end()) {
-        return false;
+RouteStatus LogicSystem::Dispatch(http::verb method, std::string_view path, std::shared_ptr<HttpConnection> con) {
+    std::size_t handler_id = 0;
+    unsigned allowed = 0;
+    auto status = _router.Match(method, path, handler_id, con->_path_params, allowed);
+    if (status == RouteStatus::MethodNotAllowed) {
+        con->_response.set(http::field::allow, Router::AllowHeader(allowed));
     }
-
-    _get_handlers[path](con);
-    return true;
-}
-
-bool LogicSystem::HandlePost(std::string path, std::shared_ptr<HttpConnection> con) {
-    if (_post_handlers.find(path) == _post_handlers.end()) {
-        return false;
+    if (status != RouteStatus::Found) {
+        return status;
     }
 
-    _post_handlers[path](con);
-    return true;
-}
\ No newline at end of file
+    con->_route_metrics = _route_metrics[handler_id].get();
+    // 事件循环监视器按路由记录占用最久的handler
+    LoopMonitor::Label(con->_route_metrics->name);
+    con->_span.SetName(con->_route_metrics->name);
+    _handlers[handler_id](con);
+    return status;
+}
@@ -3,10 +3,27 @@
 #include <functional>
 #include <map>
 #include "const.h"
+#include "Router.h"
+#include "Metrics.h"
+#include "AllocProfile.h"
 
 class HttpConnection;
 
+// ÿ·ɵ״̬ࣩͺʱע·ʱ
+struct RouteMetrics {
+    RouteMetrics(const std::string& route, const std::string& method);
+    // Ӧд¼ʱӶͷʼ
+    void Record(unsigned status, std::chrono::steady_clock::duration elapsed);
+
+    std::string name;                       // ·"GET /get_test"
+    Histogram& latency;
+    Counter* status[5];                     // 1xx5xx
+    AllocProfile::RouteCounts alloc;        // GATE_ALLOC_PROFILEʱͳƵĶѷ
+};
+
 typedef std::function<void(std::shared_ptr<HttpConnection>)> HttpHandler;
+// Э̴co_await˵ãӷӦ
+typedef std::function<net::awaitable<void>(std::shared_ptr<HttpConnection>)> AsyncHttpHandler;
 
 class LogicSystem :public Singleton<LogicSystem>
 {
@@ -14,14 +31,37 @@ class LogicSystem :public Singleton<LogicSystem>
 public:
     ~LogicSystem() = default;
 
-    bool HandleGet(std::string, std::shared_ptr<HttpConnection>);
-    bool HandlePost(std::string path, std::shared_ptr<HttpConnection> con);
+    // ·ַ·ѯ405ʱAllowͷ
+    RouteStatus Dispatch(http::verb method, std::string_view path, std::shared_ptr<HttpConnection> con);
+    // urlпʹ{name}·/user/{uid}
     void RegGet(std::string, HttpHandler handler);
     void RegPost(std::string, HttpHandler handler);
+    void RegGetAsync(std::string, AsyncHttpHandler handler);
+    void RegPostAsync(std::string, AsyncHttpHandler handler);
+    // ûƥ䵽·ɵ404405400
+    static RouteMetrics& UnmatchedMetrics();
+
+    // net::awaitable<void>ĴЭ̷ʽע
+    template <typename Handler>
+        requires std::is_same_v<std::invoke_result_t<Handler&, std::shared_ptr<HttpConnection>>, net::awaitable<void>>
+    void RegGet(std::string url, Handler handler) {
+        RegGetAsync(std::move(url), AsyncHttpHandler(std::move(handler)));
+    }
+    template <typename Handler>
+        requires std::is_same_v<std::invoke_result_t<Handler&, std::shared_ptr<HttpConnection>>, net::awaitable<void>>
+    void RegPost(std::string url, Handler handler) {
+        RegPostAsync(std::move(url), AsyncHttpHandler(std::move(handler)));
+    }
 
 private:
     LogicSystem();
+    // Э̴װͨʱЭ
+    static HttpHandler WrapAsync(AsyncHttpHandler handler);
+
+    void Reg(http::verb method, const std::string& url, HttpHandler handler);
 
-    std::map<std::string, HttpHandler> _post_handlers;
-    std::map<std::string, HttpHandler> _get_handlers;
+    Router _router;                         // ·ɱ洦_handlersе±
+    std::vector<HttpHandler> _handlers;
+    std::vector<std::unique_ptr<RouteMetrics>> _route_metrics;  // _handlersһһӦ
+    bool _blocking_handlers = false;        // [GateServer] HandlerMode = blocking˵òЭ
 };
\ No newline at end of file
@@ -0,0 +1,131 @@
+#include "LoopMonitor.h"
+#include "Logger.h"
+
+namespace {
+	thread_local LoopMonitor* t_monitor = nullptr;
+
+	// ÿͳƴڰ̽ڽʱϱhandler
+	constexpr std::size_t PROBES_PER_WINDOW = 100;
+
+	std::string LoopLabel(std::size_t index) {
+		return "loop=\"" + std::to_string(index) + "\"";
+	}
+}
+
+LoopMonitor::LoopMonitor(boost::asio::io_context& ioc, std::size_t index,
+	std::chrono::milliseconds interval, std::chrono::milliseconds slow_threshold)
+	: _timer(ioc), _index(index), _interval(interval), _slow_threshold(slow_threshold)
+	, _lag(Metrics::Inst().GetHistogram("gate_loop_lag_seconds",
+		"Delay between posting a probe handler and the io loop running it", LoopLabel(index)))
+	, _handlers(Metrics::Inst().GetCounter("gate_loop_handlers_total",
+		"Instrumented handlers executed on the io loop", LoopLabel(index)))
+	, _busy_us(Metrics::Inst().GetCounter("gate_loop_busy_microseconds_total",
+		"Time spent inside instrumented handlers on the io loop", LoopLabel(index)))
+	, _longest_us(Metrics::Inst().GetGauge("gate_loop_longest_handler_microseconds",
+		"Longest instrumented handler in the last report window", LoopLabel(index)))
+{
+
+}
+
+LoopMonitor* LoopMonitor::Current()
+{
+	return t_monitor;
+}
+
+void LoopMonitor::Start()
+{
+	t_monitor = this;
+	if (_interval.count() <= 0) {
+		return;
+	}
+	_running = true;
+	Schedule();
+}
+
+void LoopMonitor::Stop()
+{
+	_running = false;
+	_timer.cancel();
+}
+
+void LoopMonitor::Schedule()
+{
+	_timer.expires_after(_interval);
+	_timer.async_wait([this](const boost::system::error_code& ec) {
+		if (ec || !_running) {
+			return;
+		}
+		// ͶݵβѾhandlerִ֮
+		auto posted = std::chrono::steady_clock::now();
+		boost::asio::post(_timer.get_executor(), [this, posted]() {
+			OnProbe(posted);
+			});
+		});
+}
+
+void LoopMonitor::OnProbe(std::chrono::steady_clock::time_point posted)
+{
+	_lag.RecordDuration(std::chrono::steady_clock::now() - posted);
+	if (++_probes_in_window >= PROBES_PER_WINDOW) {
+		ReportWindow();
+	}
+	if (_running) {
+		Schedule();
+	}
+}
+
+void LoopMonitor::ReportWindow()
+{
+	_longest_us.Set(_longest.count());
+	if (_slow_threshold.count() > 0 && _longest >= _slow_threshold) {
+		LOG_WARN("io loop ", _index, " longest handler ", _longest_label, " took ", _longest.count(), "us");
+	}
+	_probes_in_window = 0;
+	_longest = std::chrono::microseconds(0);
+	_longest_label.clear();
+}
+
+void LoopMonitor::Enter(std::string_view label)
+{
+	if (_depth++ == 0) {
+		_busy_start = std::chrono::steady_clock::now();
+		_label = label;
+	}
+}
+
+void LoopMonitor::Leave()
+{
+	if (--_depth != 0) {
+		return;
+	}
+	auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::steady_clock::now() - _busy_start);
+	_handlers.Inc();
+	_busy_us.Inc(static_cast<std::uint64_t>(elapsed.count()));
+	if (elapsed > _longest) {
+		_longest = elapsed;
+		_longest_label.assign(_label.data(), _label.size());
+	}
+}
+
+LoopMonitor::Busy::Busy(std::string_view label)
+	: _monitor(t_monitor)
+{
+	if (_monitor) {
+		_monitor->Enter(label);
+	}
+}
+
+LoopMonitor::Busy::~Busy()
+{
+	if (_monitor) {
+		_monitor->Leave();
+	}
+}
+
+void LoopMonitor::Label(std::string_view label)
+{
+	if (t_monitor && t_monitor->_depth > 0) {
+		t_monitor->_label = label;
+	}
+}
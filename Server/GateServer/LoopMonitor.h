@@ -0,0 +1,67 @@
+#pragma once
+#include <boost/asio.hpp>
+#include <chrono>
+#include <string>
+#include <string_view>
+#include "Metrics.h"
+
+// io߳¼ѭÿio_contextһвioִ߳
+// 1. ̶Ͷһʱ̽handlerͶݵִеӳپ¼ѭŶӳ
+// 2. ӵĸصBusyͳhandlerִдͺʱסһͳƴ
+//    ռ¼ѭõhandlerӦ·ɣֵʱ־
+class LoopMonitor
+{
+public:
+	LoopMonitor(boost::asio::io_context& ioc, std::size_t index,
+		std::chrono::milliseconds interval, std::chrono::milliseconds slow_threshold);
+	LoopMonitor(const LoopMonitor&) = delete;
+	LoopMonitor& operator=(const LoopMonitor&) = delete;
+
+	// io߳ϵã󶨵ǰ̲߳ʼ̽
+	void Start();
+	void Stop();
+
+	// ǰio̵߳ļio̷߳ؿ
+	static LoopMonitor* Current();
+
+	// ͳһhandlerִУǶʱֻʱ
+	class Busy {
+	public:
+		explicit Busy(std::string_view label);
+		~Busy();
+		Busy(const Busy&) = delete;
+		Busy& operator=(const Busy&) = delete;
+	private:
+		LoopMonitor* _monitor;
+	};
+
+	// µǰhandlerıǩ·ƥ֮󻻳·label볤Ч
+	static void Label(std::string_view label);
+
+private:
+	void Schedule();
+	void OnProbe(std::chrono::steady_clock::time_point posted);
+	void Enter(std::string_view label);
+	void Leave();
+	void ReportWindow();
+
+	boost::asio::steady_timer _timer;
+	std::size_t _index;
+	std::chrono::milliseconds _interval;
+	std::chrono::microseconds _slow_threshold;
+	bool _running = false;
+
+	int _depth = 0;
+	std::chrono::steady_clock::time_point _busy_start;
+	std::string_view _label;
+
+	// ͳƴhandler
+	std::size_t _probes_in_window = 0;
+	std::chrono::microseconds _longest{ 0 };
+	std::string _longest_label;
+
+	Histogram& _lag;
+	Counter& _handlers;
+	Counter& _busy_us;
+	Gauge& _longest_us;
+};
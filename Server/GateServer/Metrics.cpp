@@ -0,0 +1,252 @@
+#include "Metrics.h"
+#include <bit>
+#include <cstdio>
+#include <stdexcept>
+
+std::uint64_t Counter::Value() const
+{
+	std::uint64_t total = 0;
+	for (const auto& shard : _shards) {
+		total += shard.value.load(std::memory_order_relaxed);
+	}
+	return total;
+}
+
+double Gauge::Value() const
+{
+	if (_callback) {
+		return _callback();
+	}
+	std::int64_t total = _set.load(std::memory_order_relaxed);
+	for (const auto& shard : _shards) {
+		total += shard.value.load(std::memory_order_relaxed);
+	}
+	return static_cast<double>(total);
+}
+
+Histogram::Histogram(double scale, std::vector<double> bounds)
+	: _scale(scale), _bounds(std::move(bounds)), _shards(new Shard[MetricsDetail::SHARDS])
+{
+
+}
+
+std::size_t Histogram::BucketIndex(std::uint64_t value)
+{
+	// С8ֵռһͰ֮ÿ28Ͱ
+	if (value < SUB_COUNT) {
+		return static_cast<std::size_t>(value);
+	}
+	int msb = 63 - std::countl_zero(value);
+	int shift = msb - SUB_BITS;
+	std::size_t index = static_cast<std::size_t>(shift + 1) * SUB_COUNT
+		+ static_cast<std::size_t>((value >> shift) & (SUB_COUNT - 1));
+	return index < BUCKETS ? index : BUCKETS - 1;
+}
+
+std::uint64_t Histogram::BucketUpperBound(std::size_t index)
+{
+	if (index < SUB_COUNT) {
+		return index;
+	}
+	int shift = static_cast<int>(index / SUB_COUNT) - 1;
+	std::uint64_t sub = index % SUB_COUNT;
+	std::uint64_t lower = (SUB_COUNT + sub) << shift;
+	return lower + (1ull << shift) - 1;
+}
+
+Histogram::Snapshot Histogram::Collect() const
+{
+	Snapshot snapshot;
+	snapshot.buckets.assign(BUCKETS, 0);
+	for (std::size_t s = 0; s < MetricsDetail::SHARDS; ++s) {
+		const auto& shard = _shards[s];
+		for (std::size_t i = 0; i < BUCKETS; ++i) {
+			auto n = shard.buckets[i].load(std::memory_order_relaxed);
+			snapshot.buckets[i] += n;
+			snapshot.count += n;
+		}
+		snapshot.sum += shard.sum.load(std::memory_order_relaxed);
+	}
+	return snapshot;
+}
+
+std::uint64_t Histogram::Snapshot::Quantile(double q) const
+{
+	if (count == 0) {
+		return 0;
+	}
+	std::uint64_t target = static_cast<std::uint64_t>(q * static_cast<double>(count));
+	if (target >= count) {
+		target = count - 1;
+	}
+	std::uint64_t seen = 0;
+	for (std::size_t i = 0; i < buckets.size(); ++i) {
+		seen += buckets[i];
+		if (seen > target) {
+			return BucketUpperBound(i);
+		}
+	}
+	return BucketUpperBound(buckets.size() - 1);
+}
+
+Metrics& Metrics::Inst()
+{
+	static Metrics* metrics = new Metrics();
+	return *metrics;
+}
+
+const std::vector<double>& Metrics::LatencyBounds()
+{
+	static const std::vector<double> bounds = {
+		0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025,
+		0.05, 0.1, 0.25, 0.5, 1, 2.5, 5, 10,
+	};
+	return bounds;
+}
+
+Metrics::Family& Metrics::GetFamily(const std::string& name, const std::string& help, Type type)
+{
+	auto iter = _families.find(name);
+	if (iter == _families.end()) {
+		Family family;
+		family.help = help;
+		family.type = type;
+		iter = _families.emplace(name, std::move(family)).first;
+	}
+	if (iter->second.type != type) {
+		throw std::invalid_argument("metric " + name + " registered with another type");
+	}
+	return iter->second;
+}
+
+Counter& Metrics::GetCounter(const std::string& name, const std::string& help, const std::string& labels)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto& slot = GetFamily(name, help, Type::Counter).counters[labels];
+	if (!slot) {
+		slot = std::make_unique<Counter>();
+	}
+	return *slot;
+}
+
+Gauge& Metrics::GetGauge(const std::string& name, const std::string& help, const std::string& labels)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto& slot = GetFamily(name, help, Type::Gauge).gauges[labels];
+	if (!slot) {
+		slot = std::make_unique<Gauge>();
+	}
+	return *slot;
+}
+
+Gauge& Metrics::GetGauge(const std::string& name, const std::string& help, const std::string& labels,
+	std::function<double()> callback)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto& slot = GetFamily(name, help, Type::Gauge).gauges[labels];
+	if (!slot) {
+		slot = std::make_unique<Gauge>(std::move(callback));
+	}
+	return *slot;
+}
+
+Histogram& Metrics::GetHistogram(const std::string& name, const std::string& help, const std::string& labels)
+{
+	return GetHistogram(name, help, labels, 1e-6, LatencyBounds());
+}
+
+Histogram& Metrics::GetHistogram(const std::string& name, const std::string& help, const std::string& labels,
+	double scale, std::vector<double> bounds)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto& slot = GetFamily(name, help, Type::Histogram).histograms[labels];
+	if (!slot) {
+		slot = std::make_unique<Histogram>(scale, std::move(bounds));
+	}
+	return *slot;
+}
+
+namespace {
+	void AppendNumber(std::string& out, double value) {
+		char buf[32];
+		std::snprintf(buf, sizeof(buf), "%.10g", value);
+		out.append(buf);
+	}
+
+	void AppendNumber(std::string& out, std::uint64_t value) {
+		out.append(std::to_string(value));
+	}
+
+	// name{labels,extra} value
+	void AppendSample(std::string& out, const std::string& name, const std::string& labels,
+		const std::string& extra) {
+		out.append(name);
+		if (!labels.empty() || !extra.empty()) {
+			out.push_back('{');
+			out.append(labels);
+			if (!labels.empty() && !extra.empty()) {
+				out.push_back(',');
+			}
+			out.append(extra);
+			out.push_back('}');
+		}
+		out.push_back(' ');
+	}
+}
+
+void Metrics::Render(std::string& out) const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	for (const auto& [name, family] : _families) {
+		out.append("# HELP ").append(name).append(" ").append(family.help).append("\n");
+		switch (family.type) {
+		case Type::Counter:
+			out.append("# TYPE ").append(name).append(" counter\n");
+			for (const auto& [labels, counter] : family.counters) {
+				AppendSample(out, name, labels, "");
+				AppendNumber(out, counter->Value());
+				out.push_back('\n');
+			}
+			break;
+		case Type::Gauge:
+			out.append("# TYPE ").append(name).append(" gauge\n");
+			for (const auto& [labels, gauge] : family.gauges) {
+				AppendSample(out, name, labels, "");
+				AppendNumber(out, gauge->Value());
+				out.push_back('\n');
+			}
+			break;
+		case Type::Histogram:
+			out.append("# TYPE ").append(name).append(" histogram\n");
+			for (const auto& [labels, histogram] : family.histograms) {
+				auto snapshot = histogram->Collect();
+				// ͰϽ粻leĶleͰԽ߽ʱв12.5%
+				std::size_t bucket = 0;
+				std::uint64_t cumulative = 0;
+				for (double bound : histogram->Bounds()) {
+					while (bucket < Histogram::BUCKETS
+						&& static_cast<double>(Histogram::BucketUpperBound(bucket)) * histogram->Scale() <= bound) {
+						cumulative += snapshot.buckets[bucket++];
+					}
+					std::string le = "le=\"";
+					char buf[32];
+					std::snprintf(buf, sizeof(buf), "%g", bound);
+					le.append(buf).append("\"");
+					AppendSample(out, name + "_bucket", labels, le);
+					AppendNumber(out, cumulative);
+					out.push_back('\n');
+				}
+				AppendSample(out, name + "_bucket", labels, "le=\"+Inf\"");
+				AppendNumber(out, snapshot.count);
+				out.push_back('\n');
+				AppendSample(out, name + "_sum", labels, "");
+				AppendNumber(out, static_cast<double>(snapshot.sum) * histogram->Scale());
+				out.push_back('\n');
+				AppendSample(out, name + "_count", labels, "");
+				AppendNumber(out, snapshot.count);
+				out.push_back('\n');
+			}
+			break;
+		}
+	}
+}
@@ -0,0 +1,163 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// ָ갴̷߳Ƭÿ̶̹߳дԼķƬֻrelaxedԭӼӣûп˾
+// ֻץȡ/metricsʱŰзƬϲ
+namespace MetricsDetail {
+	constexpr std::size_t SHARDS = 16;
+
+	// ǰ߳ʹõķƬ±꣬һεʱ˳
+	inline std::size_t ShardIndex() {
+		static std::atomic<std::size_t> next{ 0 };
+		thread_local std::size_t index = next.fetch_add(1, std::memory_order_relaxed) % SHARDS;
+		return index;
+	}
+
+	struct alignas(64) PaddedCounter {
+		std::atomic<std::uint64_t> value{ 0 };
+	};
+
+	struct alignas(64) PaddedGauge {
+		std::atomic<std::int64_t> value{ 0 };
+	};
+}
+
+// 
+class Counter
+{
+public:
+	void Inc(std::uint64_t n = 1) {
+		_shards[MetricsDetail::ShardIndex()].value.fetch_add(n, std::memory_order_relaxed);
+	}
+	std::uint64_t Value() const;
+
+private:
+	std::array<MetricsDetail::PaddedCounter, MetricsDetail::SHARDS> _shards;
+};
+
+// ɼ˲ʱֵԾҲעΪץȡʱصȡֵ
+class Gauge
+{
+public:
+	Gauge() = default;
+	explicit Gauge(std::function<double()> callback) : _callback(std::move(callback)) {}
+
+	void Add(std::int64_t n) {
+		_shards[MetricsDetail::ShardIndex()].value.fetch_add(n, std::memory_order_relaxed);
+	}
+	void Sub(std::int64_t n) { Add(-n); }
+	// ֱõǰֵʺڸµӳؿҪAdd
+	void Set(std::int64_t n) { _set.store(n, std::memory_order_relaxed); }
+	double Value() const;
+
+private:
+	std::array<MetricsDetail::PaddedGauge, MetricsDetail::SHARDS> _shards;
+	std::atomic<std::int64_t> _set{ 0 };
+	std::function<double()> _callback;
+};
+
+// HDRֱͼ2ݷ飬ÿԷֳ8Ͱ12.5%
+// ¼΢룩ʱscale㵥λ̶le߽ϲPrometheusֱͼ
+class Histogram
+{
+public:
+	static constexpr int SUB_BITS = 3;
+	static constexpr std::size_t SUB_COUNT = 1 << SUB_BITS;
+	static constexpr std::size_t BUCKETS = 40 * SUB_COUNT;
+
+	Histogram(double scale, std::vector<double> bounds);
+
+	void Record(std::uint64_t value) {
+		auto& shard = _shards[MetricsDetail::ShardIndex()];
+		shard.buckets[BucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+		shard.sum.fetch_add(value, std::memory_order_relaxed);
+	}
+
+	// ΢¼ʱ
+	template<typename Rep, typename Period>
+	void RecordDuration(std::chrono::duration<Rep, Period> duration) {
+		auto us = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+		Record(us > 0 ? static_cast<std::uint64_t>(us) : 0);
+	}
+
+	static std::size_t BucketIndex(std::uint64_t value);
+	// Ͱܱʾֵ
+	static std::uint64_t BucketUpperBound(std::size_t index);
+
+	struct Snapshot {
+		std::vector<std::uint64_t> buckets;
+		std::uint64_t count = 0;
+		std::uint64_t sum = 0;
+
+		// λqȡ01ضӦͰϽ磨δscale
+		std::uint64_t Quantile(double q) const;
+	};
+	Snapshot Collect() const;
+
+	double Scale() const { return _scale; }
+	const std::vector<double>& Bounds() const { return _bounds; }
+
+private:
+	struct alignas(64) Shard {
+		std::atomic<std::uint64_t> buckets[BUCKETS] = {};
+		std::atomic<std::uint64_t> sum{ 0 };		// ںϲʱɸͰӵõ¼ʱһԭӲ
+	};
+
+	double _scale;
+	std::vector<double> _bounds;
+	std::unique_ptr<Shard[]> _shards;
+};
+
+// ָעֺͱǩָ꣬صһֱЧ÷ʱȡһλ
+// /metrics·ɵRenderPrometheusıʽ
+class Metrics
+{
+public:
+	// ӺӳʱԿָܸ
+	static Metrics& Inst();
+
+	// labelsPrometheusʽıǩ route="/get_test",method="GET"
+	Counter& GetCounter(const std::string& name, const std::string& help, const std::string& labels = "");
+	Gauge& GetGauge(const std::string& name, const std::string& help, const std::string& labels = "");
+	// ץȡʱcallbackȡֵgaugeѴͬͬǩ򱣳ԭ
+	Gauge& GetGauge(const std::string& name, const std::string& help, const std::string& labels,
+		std::function<double()> callback);
+	// ĬΪλĺʱֱͼ΢¼
+	Histogram& GetHistogram(const std::string& name, const std::string& help, const std::string& labels = "");
+	Histogram& GetHistogram(const std::string& name, const std::string& help, const std::string& labels,
+		double scale, std::vector<double> bounds);
+
+	// Ĭϵĺʱ߽磬λ
+	static const std::vector<double>& LatencyBounds();
+
+	void Render(std::string& out) const;
+
+private:
+	Metrics() = default;
+	Metrics(const Metrics&) = delete;
+	Metrics& operator=(const Metrics&) = delete;
+
+	enum class Type { Counter, Gauge, Histogram };
+
+	struct Family {
+		std::string help;
+		Type type;
+		std::map<std::string, std::unique_ptr<Counter>> counters;
+		std::map<std::string, std::unique_ptr<Gauge>> gauges;
+		std::map<std::string, std::unique_ptr<Histogram>> histograms;
+	};
+
+	Family& GetFamily(const std::string& name, const std::string& help, Type type);
+
+	mutable std::mutex _mutex;
+	std::map<std::string, Family> _families;
+};
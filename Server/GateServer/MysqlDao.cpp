@@ -1,7 +1,17 @@
 #include "MysqlDao.h"
 #include "ConfigMgr.h"
+#include "Tracer.h"
 #include <iostream>
 
+namespace {
+    // һSQLspanں̵߳ǰ£δʱ¼
+    Span StatementSpan(std::string_view name) {
+        Span span(Tracer::Current(), name, SpanKind::Client);
+        span.SetAttribute("db.system", "mysql");
+        return span;
+    }
+}
+
 MysqlDao::MysqlDao()
 {
     auto& cfg = ConfigMgr::Inst();
@@ -10,7 +20,12 @@ MysqlDao::MysqlDao()
     const auto& pwd = cfg["Mysql"]["Passwd"];
     const auto& schema = cfg["Mysql"]["Schema"];
     const auto& user = cfg["Mysql"]["User"];
-    pool_.reset(new MySqlPool(host + ":" + port, user, pwd, schema, 5));
+    pool_.reset(new MySqlPool(host + ":" + port, user, pwd, schema, 5, PoolMetrics::WaitTimeout("Mysql")));
+}
+
+MysqlDao::MysqlDao(std::unique_ptr<MySqlPool> pool)
+    : pool_(std::move(pool))
+{
 }
 
 MysqlDao::~MysqlDao() {
@@ -41,7 +56,7 @@ int MysqlDao::RegUser(const std::string& name, const std::string& email, const s
         Row row = res.fetchOne();
         if (row) {
             int result = row[0].get<int>();
-            std::cout << "Result: " << result << std::endl;
+            LOG_DEBUG("Result: ", result);
             pool_->returnConnection(std::move(con));
             return result;
         }
@@ -50,7 +65,7 @@ int MysqlDao::RegUser(const std::string& name, const std::string& email, const s
     }
     catch (Error& e) {
         pool_->returnConnection(std::move(con));
-        std::cerr << "Error: " << e.what() << std::endl;
+        LOG_ERROR("Error: ", e.what());
         return -1;
     }
 }
@@ -69,27 +84,32 @@ int MysqlDao::RegUserTransaction(const std::string& name, const std::string& ema
         sess.startTransaction();
 
         // ִеһݿemailǷѴ
+        // ÿһspanֵһʱһ
+        Span stmt_span = StatementSpan("mysql SELECT user.email");
         RowResult res_email = sess.sql("SELECT 1 FROM user WHERE email = ?").bind(email).execute();
         if (res_email.count() > 0) {
             sess.rollback();
-            std::cout << "email " << email << " exist" << std::endl;
+            LOG_DEBUG("email ", email, " exist");
             pool_->returnConnection(std::move(con));
             return 0;
         }
 
         // ׼ѯûǷظ
+        stmt_span = StatementSpan("mysql SELECT user.name");
         RowResult res_name = sess.sql("SELECT 1 FROM user WHERE name = ?").bind(name).execute();
         if (res_name.count() > 0) {
             sess.rollback();
-            std::cout << "name " << name << " exist" << std::endl;
+            LOG_DEBUG("name ", name, " exist");
             pool_->returnConnection(std::move(con));
             return 0;
         }
 
         // ׼ûid
+        stmt_span = StatementSpan("mysql UPDATE user_id");
         sess.sql("UPDATE user_id SET id = id + 1").execute();
 
         // ȡº id ֵ
+        stmt_span = StatementSpan("mysql SELECT user_id");
         RowResult res_uid = sess.sql("SELECT id FROM user_id").execute();
         Row row_uid = res_uid.fetchOne();
         int newId = 0;
@@ -98,20 +118,23 @@ int MysqlDao::RegUserTransaction(const std::string& name, const std::string& ema
             newId = row_uid[0].get<int>();
         }
         else {
-            std::cout << "select id from user_id failed" << std::endl;
+            LOG_ERROR("select id from user_id failed");
             sess.rollback();
             pool_->returnConnection(std::move(con));
             return -1;
         }
 
         // userϢ
+        stmt_span = StatementSpan("mysql INSERT user");
         sess.sql("INSERT INTO user (uid, name, email, pwd) VALUES (?, ?, ?, ?)")
             .bind(newId, name, email, pwd)
             .execute();
 
+        stmt_span = StatementSpan("mysql COMMIT");
+
         // ύ
         sess.commit();
-        std::cout << "newuser insert into user success" << std::endl;
+        LOG_DEBUG("newuser insert into user success");
         pool_->returnConnection(std::move(con));
         return newId;
     }
@@ -123,7 +146,7 @@ int MysqlDao::RegUserTransaction(const std::string& name, const std::string& ema
             }
             catch (...) {}
         }
-        std::cerr << "Error: " << e.what() << std::endl;
+        LOG_ERROR("Error: ", e.what());
         pool_->returnConnection(std::move(con));
         return -1;
     }
@@ -145,7 +168,7 @@ bool MysqlDao::CheckEmail(const std::string& name, const std::string& email) {
         Row row = res.fetchOne();
         if (row) {
             std::string db_email = row[0].get<std::string>();
-            std::cout << "Check Email: " << db_email << std::endl;
+            LOG_DEBUG("Check Email: ", db_email);
             bool result = (email == db_email);
             pool_->returnConnection(std::move(con));
             return result;
@@ -155,7 +178,7 @@ bool MysqlDao::CheckEmail(const std::string& name, const std::string& email) {
     }
     catch (Error& e) {
         pool_->returnConnection(std::move(con));
-        std::cerr << "Error: " << e.what() << std::endl;
+        LOG_ERROR("Error: ", e.what());
         return false;
     }
 }
@@ -174,13 +197,13 @@ bool MysqlDao::UpdatePwd(const std::string& name, const std::string& newpwd) {
             .bind(newpwd, name)
             .execute();
 
-        std::cout << "Updated rows: " << res.getAffectedItemsCount() << std::endl;
+        LOG_DEBUG("Updated rows: ", res.getAffectedItemsCount());
         pool_->returnConnection(std::move(con));
         return true;
     }
     catch (Error& e) {
         pool_->returnConnection(std::move(con));
-        std::cerr << "Error: " << e.what() << std::endl;
+        LOG_ERROR("Error: ", e.what());
         return false;
     }
 }
@@ -206,7 +229,7 @@ bool MysqlDao::CheckPwd(const std::string& name, const std::string& pwd, UserInf
             // ʹʣuid=0, name=1, email=2, pwd=3
             origin_pwd = row[3].get<std::string>();  // pwd ڵ4У3
             // ӡѯ
-            std::cout << "Password: " << origin_pwd << std::endl;
+            LOG_DEBUG("Password: ", origin_pwd);
 
             if (pwd != origin_pwd) {
                 pool_->returnConnection(std::move(con));
@@ -224,7 +247,7 @@ bool MysqlDao::CheckPwd(const std::string& name, const std::string& pwd, UserInf
     }
     catch (Error& e) {
         pool_->returnConnection(std::move(con));
-        std::cerr << "Error: " << e.what() << std::endl;
+        LOG_ERROR("Error: ", e.what());
         return false;
     }
 }
@@ -254,7 +277,7 @@ bool MysqlDao::TestProcedure(const std::string& email, int& uid, std::string& na
         }
 
         uid = row_uid[0].get<int>();
-        std::cout << "uid: " << uid << std::endl;
+        LOG_DEBUG("uid: ", uid);
 
         RowResult res_name = sess.sql("SELECT @userName AS name").execute();
         Row row_name = res_name.fetchOne();
@@ -264,14 +287,14 @@ bool MysqlDao::TestProcedure(const std::string& email, int& uid, std::string& na
         }
 
         name = row_name[0].get<std::string>();
-        std::cout << "name: " << name << std::endl;
+        LOG_DEBUG("name: ", name);
         pool_->returnConnection(std::move(con));
         return true;
 
     }
     catch (Error& e) {
         pool_->returnConnection(std::move(con));
-        std::cerr << "Error: " << e.what() << std::endl;
+        LOG_ERROR("Error: ", e.what());
         return false;
     }
 }
\ No newline at end of file
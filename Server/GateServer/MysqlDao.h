@@ -8,7 +8,9 @@
 #include <condition_variable>
 #include <atomic>
 #include <chrono>
+#include <vector>
 #include <mysqlx/xdevapi.h>
+#include "PoolMetrics.h"
 
 using namespace mysqlx;
 
@@ -18,13 +20,16 @@ public:
     SqlConnection(Session* sess, int64_t lasttime) :_sess(sess), _last_oper_time(lasttime) {}
     std::unique_ptr<Session> _sess;
     int64_t _last_oper_time;
+    PoolMetrics::TimePoint _acquire_time;  // ʱ䣬ͳƳʱ
 };
 
 // MySQL ӳ
 class MySqlPool {
 public:
-    MySqlPool(const std::string& url, const std::string& user, const std::string& pass, const std::string& schema, int poolSize)
-        : url_(url), user_(user), pass_(pass), schema_(schema), poolSize_(poolSize), b_stop_(false), _fail_count(0) {
+    MySqlPool(const std::string& url, const std::string& user, const std::string& pass, const std::string& schema, int poolSize,
+        std::chrono::milliseconds waitTimeout = std::chrono::milliseconds(0))
+        : url_(url), user_(user), pass_(pass), schema_(schema), poolSize_(poolSize), b_stop_(false), _fail_count(0),
+        _wait_timeout(waitTimeout), _metrics("mysql") {
         try {
             // ַ
             std::string connectionString = "mysqlx://" + user_ + ":" + pass_ + "@" + url_ + "/" + schema_;
@@ -37,6 +42,7 @@ public:
                 long long timestamp = std::chrono::duration_cast<std::chrono::seconds>(currentTime).count();
                 pool_.push(std::make_unique<SqlConnection>(sess, timestamp));
             }
+            _metrics.SetIdle(pool_.size());
 
             _check_thread = std::thread([this]() {
                 while (!b_stop_) {
@@ -49,10 +55,22 @@ public:
         }
         catch (Error& e) {
             // 쳣
-            std::cout << "mysql pool init failed, error is " << e.what() << std::endl;
+            LOG_ERROR("mysql pool init failed, error is ", e.what());
         }
     }
 
+    // ʹѾõӣ̣߳Ҳ
+    // ΢׼ûлỰӣȡӵĿ
+    MySqlPool(std::vector<std::unique_ptr<SqlConnection>> connections,
+        std::chrono::milliseconds waitTimeout = std::chrono::milliseconds(0))
+        : poolSize_(static_cast<int>(connections.size())), b_stop_(false), _fail_count(0),
+        _wait_timeout(waitTimeout), _metrics("mysql") {
+        for (auto& con : connections) {
+            pool_.push(std::move(con));
+        }
+        _metrics.SetIdle(pool_.size());
+    }
+
     void checkConnectionPro() {
         // 1)ȶȡĿ괦
         size_t targetCount;
@@ -77,6 +95,7 @@ public:
                 }
                 con = std::move(pool_.front());
                 pool_.pop();
+                _metrics.SetIdle(pool_.size());
             }
 
             bool healthy = true;
@@ -87,7 +106,7 @@ public:
                     con->_last_oper_time = timestamp;
                 }
                 catch (Error& e) {
-                    std::cout << "Error keeping connection alive: " << e.what() << std::endl;
+                    LOG_ERROR("Error keeping connection alive: ", e.what());
                     healthy = false;
                     _fail_count++;
                 }
@@ -98,6 +117,7 @@ public:
             {
                 std::lock_guard<std::mutex> guard(mutex_);
                 pool_.push(std::move(con));
+                _metrics.SetIdle(pool_.size());
                 cond_.notify_one();
             }
 
@@ -124,35 +144,53 @@ public:
             {
                 std::lock_guard<std::mutex> guard(mutex_);
                 pool_.push(std::move(newCon));
+                _metrics.SetIdle(pool_.size());
+                cond_.notify_one();
             }
 
-            std::cout << "mysql connection reconnect success" << std::endl;
+            LOG_INFO("mysql connection reconnect success");
+            _metrics.OnReconnect(true);
             return true;
 
         }
         catch (Error& e) {
-            std::cout << "Reconnect failed, error is " << e.what() << std::endl;
+            LOG_ERROR("Reconnect failed, error is ", e.what());
+            _metrics.OnReconnect(false);
             return false;
         }
     }
 
+    // ˵ȴʱʱʱؿָ
     std::unique_ptr<SqlConnection> getConnection() {
+        auto wait_start = std::chrono::steady_clock::now();
         std::unique_lock<std::mutex> lock(mutex_);
-        cond_.wait(lock, [this] {
+        auto ready = [this] {
             if (b_stop_) {
                 return true;
             }
-            return !pool_.empty(); });
+            return !pool_.empty(); };
+        if (_wait_timeout.count() > 0) {
+            if (!cond_.wait_for(lock, _wait_timeout, ready)) {
+                _metrics.OnTimeout();
+                return nullptr;
+            }
+        }
+        else {
+            cond_.wait(lock, ready);
+        }
         if (b_stop_) {
             return nullptr;
         }
         std::unique_ptr<SqlConnection> con(std::move(pool_.front()));
         pool_.pop();
+        _metrics.SetIdle(pool_.size());
+        con->_acquire_time = _metrics.OnAcquire(wait_start);
         return con;
     }
 
     void returnConnection(std::unique_ptr<SqlConnection> con) {
         std::unique_lock<std::mutex> lock(mutex_);
+        _metrics.OnRelease(con->_acquire_time);
         if (b_stop_) {
             return;
         }
@@ -161,6 +199,7 @@ public:
         long long timestamp = std::chrono::duration_cast<std::chrono::seconds>(currentTime).count();
         con->_last_oper_time = timestamp;
         pool_.push(std::move(con));
+        _metrics.SetIdle(pool_.size());
         cond_.notify_one();
     }
 
@@ -197,6 +236,8 @@ private:
     std::atomic<bool> b_stop_;
     std::thread _check_thread;
     std::atomic<int> _fail_count;
+    std::chrono::milliseconds _wait_timeout;   // ȡӵĵȴʱ0ʾһֱȴ
+    PoolMetrics _metrics;
 };
 
 struct UserInfo {
@@ -206,17 +247,21 @@ struct UserInfo {
     std::string email;
 };
 
+// ӿ麯FakeMysqlDaoڴеʵͬĽӿ
 class MysqlDao
 {
 public:
     MysqlDao();
-    ~MysqlDao();
-    int RegUser(const std::string& name, const std::string& email, const std::string& pwd);
-    int RegUserTransaction(const std::string& name, const std::string& email, const std::string& pwd);
-    bool CheckEmail(const std::string& name, const std::string& email);
-    bool UpdatePwd(const std::string& name, const std::string& newpwd);
-    bool CheckPwd(const std::string& name, const std::string& pwd, UserInfo& userInfo);
-    bool TestProcedure(const std::string& email, int& uid, std::string& name);
+    virtual ~MysqlDao();
+    virtual int RegUser(const std::string& name, const std::string& email, const std::string& pwd);
+    virtual int RegUserTransaction(const std::string& name, const std::string& email, const std::string& pwd);
+    virtual bool CheckEmail(const std::string& name, const std::string& email);
+    virtual bool UpdatePwd(const std::string& name, const std::string& newpwd);
+    virtual bool CheckPwd(const std::string& name, const std::string& pwd, UserInfo& userInfo);
+    virtual bool TestProcedure(const std::string& email, int& uid, std::string& name);
+protected:
+    // ʹøӳأָʱMySQLҪӳص
+    explicit MysqlDao(std::unique_ptr<MySqlPool> pool);
 private:
     std::unique_ptr<MySqlPool> pool_;
 };
@@ -1,6 +1,9 @@
 #pragma once
 #include "const.h"
 #include "MysqlDao.h"
+#include "FakeMysqlDao.h"
+#include "BackendExecutor.h"
+#include "Tracer.h"
 
 // 
 class MysqlMgr : public Singleton<MysqlMgr>
@@ -9,9 +12,35 @@ class MysqlMgr : public Singleton<MysqlMgr>
 public:
     // 
     int RegUser(const std::string& name, const std::string& email, const std::string& pwd) {
-        return dao_.RegUserTransaction(name, email, pwd);
+        return dao_->RegUserTransaction(name, email, pwd);
+    }
+    // Э̰汾RegUserںִ̳߳У
+    // traceΪ̵߳ĵǰģеÿһspan
+    net::awaitable<int> AsyncRegUser(std::string name, std::string email, std::string pwd, TraceContext trace = {}) {
+        Span span(trace, "mysql RegUserTransaction", SpanKind::Client);
+        span.SetAttribute("db.system", "mysql");
+        auto context = span.Context();
+        // RedisMgr::AsyncGetһȰ󶨵ֲGCC 12lambdaʱ
+        auto work = [this, name, email, pwd, context]() {
+            Tracer::ScopedContext scope(context);
+            return RegUser(name, email, pwd);
+            };
+        int uid = co_await BackendExecutor::GetInstance()->Run(std::move(work));
+        if (uid == -1) {
+            span.SetError("transaction failed");
+        }
+        co_return uid;
     }
 private:
-    MysqlMgr() : dao_() {}
-    MysqlDao dao_;
+    // config.ini[FakeBackend] Mysql = trueʱʹڴеļʵ
+    MysqlMgr() {
+        auto behavior = FakeBehavior::Load("Mysql");
+        if (behavior.enabled) {
+            dao_ = std::make_unique<FakeMysqlDao>(behavior);
+        }
+        else {
+            dao_ = std::make_unique<MysqlDao>();
+        }
+    }
+    std::unique_ptr<MysqlDao> dao_;
 };
\ No newline at end of file
@@ -0,0 +1,50 @@
+#include "PoolMetrics.h"
+#include "ConfigMgr.h"
+
+namespace {
+	std::string PoolLabel(const std::string& pool) {
+		return "pool=\"" + pool + "\"";
+	}
+}
+
+PoolMetrics::PoolMetrics(const std::string& pool)
+	: _wait(Metrics::Inst().GetHistogram("gate_pool_wait_seconds",
+		"Time spent waiting to acquire a pooled backend connection", PoolLabel(pool)))
+	, _hold(Metrics::Inst().GetHistogram("gate_pool_hold_seconds",
+		"Time a pooled backend connection is held before being returned", PoolLabel(pool)))
+	, _in_use(Metrics::Inst().GetGauge("gate_pool_in_use",
+		"Pooled backend connections currently lent out", PoolLabel(pool)))
+	, _idle(Metrics::Inst().GetGauge("gate_pool_idle",
+		"Pooled backend connections currently idle", PoolLabel(pool)))
+	, _timeouts(Metrics::Inst().GetCounter("gate_pool_wait_timeouts_total",
+		"Acquires that gave up after the configured wait timeout", PoolLabel(pool)))
+	, _reconnects(Metrics::Inst().GetCounter("gate_pool_reconnects_total",
+		"Backend reconnect attempts by result", PoolLabel(pool) + ",result=\"ok\""))
+	, _reconnect_failures(Metrics::Inst().GetCounter("gate_pool_reconnects_total",
+		"Backend reconnect attempts by result", PoolLabel(pool) + ",result=\"failed\""))
+{
+
+}
+
+PoolMetrics::TimePoint PoolMetrics::OnAcquire(TimePoint wait_start)
+{
+	auto now = std::chrono::steady_clock::now();
+	_wait.RecordDuration(now - wait_start);
+	_in_use.Add(1);
+	return now;
+}
+
+void PoolMetrics::OnRelease(TimePoint acquired)
+{
+	_hold.RecordDuration(std::chrono::steady_clock::now() - acquired);
+	_in_use.Sub(1);
+}
+
+std::chrono::milliseconds PoolMetrics::WaitTimeout(const std::string& section)
+{
+	std::string value = ConfigMgr::Inst()[section]["PoolWaitTimeout"];
+	if (value.empty()) {
+		return std::chrono::milliseconds(0);
+	}
+	return std::chrono::milliseconds(atoi(value.c_str()));
+}
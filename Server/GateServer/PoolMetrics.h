@@ -0,0 +1,37 @@
+#pragma once
+#include "Metrics.h"
+#include <chrono>
+#include <string>
+
+// ӳָ꣺ȡӵĵȴʱ䡢ӱеʱ䡢úͿȴʱ
+// RedisMySQLӳظһǩΪpool="redis"/"mysql"
+class PoolMetrics
+{
+public:
+	typedef std::chrono::steady_clock::time_point TimePoint;
+
+	explicit PoolMetrics(const std::string& pool);
+
+	// ȡʱã¼wait_startʼĵȴʱ䣬ȡʱ㣬黹ʱʱ
+	TimePoint OnAcquire(TimePoint wait_start);
+	// 黹ʱ
+	void OnRelease(TimePoint acquired);
+	// ȴʱûȡ
+	void OnTimeout() { _timeouts.Inc(); }
+	// 
+	void OnReconnect(bool success) { (success ? _reconnects : _reconnect_failures).Inc(); }
+	// ӳصڸ¿
+	void SetIdle(std::size_t idle) { _idle.Set(static_cast<std::int64_t>(idle)); }
+
+	// ȡеĵȴʱ룩0ʾһֱȴ
+	static std::chrono::milliseconds WaitTimeout(const std::string& section);
+
+private:
+	Histogram& _wait;
+	Histogram& _hold;
+	Gauge& _in_use;
+	Gauge& _idle;
+	Counter& _timeouts;
+	Counter& _reconnects;
+	Counter& _reconnect_failures;
+};
@@ -0,0 +1,211 @@
+#include "QueryString.h"
+#include <cctype>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#define QUERY_STRING_USE_SSE2
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+namespace {
+	//char תΪ16
+	unsigned char ToHex(unsigned char x)
+	{
+		return  x > 9 ? x + 55 : x + 48;
+	}
+
+	// 16ַתΪֵ16ַʱ-1
+	int FromHex(unsigned char x)
+	{
+		if (x >= 'A' && x <= 'F') return x - 'A' + 10;
+		if (x >= 'a' && x <= 'f') return x - 'a' + 10;
+		if (x >= '0' && x <= '9') return x - '0';
+		return -1;
+	}
+
+#ifdef QUERY_STRING_USE_SSE2
+	inline unsigned CountTrailingZeros(unsigned mask)
+	{
+#ifdef _MSC_VER
+		unsigned long index;
+		_BitScanForward(&index, mask);
+		return static_cast<unsigned>(index);
+#else
+		return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+	}
+#endif
+}
+
+// url
+std::string UrlEncode(const std::string& str)
+{
+	std::string strTemp;
+	strTemp.reserve(str.size());
+	size_t length = str.length();
+	for (size_t i = 0; i < length; i++)
+	{
+		//жǷֺĸ
+		if (isalnum((unsigned char)str[i]) ||
+			(str[i] == '-') ||
+			(str[i] == '_') ||
+			(str[i] == '.') ||
+			(str[i] == '~'))
+			strTemp += str[i];
+		else if (str[i] == ' ') //Ϊַ
+			strTemp += "+";
+		else
+		{
+			//ַҪǰ%Ҹλ͵λֱתΪ16
+			strTemp += '%';
+			strTemp += ToHex((unsigned char)str[i] >> 4);
+			strTemp += ToHex((unsigned char)str[i] & 0x0F);
+		}
+	}
+	return strTemp;
+}
+
+// url
+bool UrlDecode(std::string_view str, std::string& out)
+{
+	out.clear();
+	out.reserve(str.size());
+	size_t length = str.length();
+	for (size_t i = 0; i < length; i++)
+	{
+		//ԭ+Ϊ
+		if (str[i] == '+') out += ' ';
+		//%ַ16תΪcharƴ
+		else if (str[i] == '%')
+		{
+			if (i + 2 >= length) {
+				return false;
+			}
+			int high = FromHex((unsigned char)str[i + 1]);
+			int low = FromHex((unsigned char)str[i + 2]);
+			if (high < 0 || low < 0) {
+				return false;
+			}
+			out += static_cast<char>(high * 16 + low);
+			i += 2;
+		}
+		else out += str[i];
+	}
+	return true;
+}
+
+std::string QueryParam::Key() const
+{
+	std::string result;
+	if (!encoded || !UrlDecode(key, result)) {
+		result.assign(key.data(), key.size());
+	}
+	return result;
+}
+
+std::string QueryParam::Value() const
+{
+	std::string result;
+	if (!encoded || !UrlDecode(value, result)) {
+		result.assign(value.data(), value.size());
+	}
+	return result;
+}
+
+bool QueryParams::Parse(std::string_view query)
+{
+	_params.clear();
+	std::size_t pair_begin = 0;
+	std::size_t eq_pos = std::string_view::npos;
+	bool encoded = false;
+	bool valid = true;
+
+	// һַfalseʾ%ת岻Ϸ
+	auto on_special = [&](std::size_t pos) {
+		switch (query[pos]) {
+		case '&':
+			AddPair(query, pair_begin, pos, eq_pos, encoded);
+			pair_begin = pos + 1;
+			eq_pos = std::string_view::npos;
+			encoded = false;
+			break;
+		case '=':
+			if (eq_pos == std::string_view::npos) {
+				eq_pos = pos;
+			}
+			break;
+		case '+':
+			encoded = true;
+			break;
+		case '%':
+			// תУ飬ȡֵʱͲʧ
+			if (pos + 2 >= query.size() || FromHex((unsigned char)query[pos + 1]) < 0
+				|| FromHex((unsigned char)query[pos + 2]) < 0) {
+				valid = false;
+			}
+			encoded = true;
+			break;
+		}
+	};
+
+	std::size_t pos = 0;
+#ifdef QUERY_STRING_USE_SSE2
+	// ÿαȽ16ֽڣõַλ룬ֻеλ
+	const __m128i amp = _mm_set1_epi8('&');
+	const __m128i eq = _mm_set1_epi8('=');
+	const __m128i pct = _mm_set1_epi8('%');
+	const __m128i plus = _mm_set1_epi8('+');
+	for (; pos + 16 <= query.size() && valid; pos += 16) {
+		__m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(query.data() + pos));
+		__m128i hit = _mm_or_si128(
+			_mm_or_si128(_mm_cmpeq_epi8(chunk, amp), _mm_cmpeq_epi8(chunk, eq)),
+			_mm_or_si128(_mm_cmpeq_epi8(chunk, pct), _mm_cmpeq_epi8(chunk, plus)));
+		unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(hit));
+		while (mask != 0) {
+			on_special(pos + CountTrailingZeros(mask));
+			mask &= mask - 1;
+		}
+	}
+#endif
+	for (; pos < query.size() && valid; ++pos) {
+		char c = query[pos];
+		if (c == '&' || c == '=' || c == '%' || c == '+') {
+			on_special(pos);
+		}
+	}
+
+	if (!valid) {
+		_params.clear();
+		return false;
+	}
+	// һԣû & ָ
+	AddPair(query, pair_begin, query.size(), eq_pos, encoded);
+	return true;
+}
+
+void QueryParams::AddPair(std::string_view query, std::size_t begin, std::size_t end,
+	std::size_t eq_pos, bool encoded)
+{
+	// û'='ƬβǼֵԣ
+	if (eq_pos == std::string_view::npos || eq_pos >= end) {
+		return;
+	}
+	QueryParam param;
+	param.key = query.substr(begin, eq_pos - begin);
+	param.value = query.substr(eq_pos + 1, end - eq_pos - 1);
+	param.encoded = encoded;
+	_params.push_back(param);
+}
+
+bool QueryParams::Get(std::string_view key, std::string& value) const
+{
+	for (auto it = _params.rbegin(); it != _params.rend(); ++it) {
+		if (it->encoded ? it->Key() == key : it->key == key) {
+			value = it->Value();
+			return true;
+		}
+	}
+	return false;
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+
+// url
+std::string UrlEncode(const std::string& str);
+// url룬ʮƵ%תʱfalse
+bool UrlDecode(std::string_view str, std::string& out);
+
+// ѯеһkey/valueֱָtargetֻڱڼЧ
+struct QueryParam {
+	std::string_view key;
+	std::string_view value;
+	bool encoded = false;		// keyvalueк'%''+'ȡֵʱҪ
+
+	// ȡkey/valueûתַʱ
+	std::string Key() const;
+	std::string Value() const;
+};
+
+// ѯһɨҳ'&''=''%''+'ֻ¼λã
+// ֻкתַĲȡֵʱŽ
+class QueryParams
+{
+public:
+	typedef std::vector<QueryParam>::const_iterator const_iterator;
+
+	// '?'֮Ĳѯ%ת岻Ϸʱfalseɵ÷ظ400
+	bool Parse(std::string_view query);
+	void Clear() { _params.clear(); }
+
+	// keyȡֵظkeyһΪ׼
+	bool Get(std::string_view key, std::string& value) const;
+
+	std::size_t Size() const { return _params.size(); }
+	bool Empty() const { return _params.empty(); }
+	const_iterator begin() const { return _params.begin(); }
+	const_iterator end() const { return _params.end(); }
+
+private:
+	void AddPair(std::string_view query, std::size_t begin, std::size_t end,
+		std::size_t eq_pos, bool encoded);
+
+	std::vector<QueryParam> _params;	// ʱ
+};
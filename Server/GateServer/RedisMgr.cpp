@@ -6,7 +6,8 @@ RedisMgr::RedisMgr() {
 	auto host = gCfgMgr["Redis"]["Host"];
 	auto port = gCfgMgr["Redis"]["Port"];
 	auto pwd = gCfgMgr["Redis"]["Passwd"];
-	_con_pool.reset(new RedisConPool(5, host.c_str(), atoi(port.c_str()), pwd.c_str()));
+	_con_pool.reset(new RedisConPool(5, host.c_str(), atoi(port.c_str()), pwd.c_str(),
+		PoolMetrics::WaitTimeout("Redis")));
 }
 
 RedisMgr::~RedisMgr() {
@@ -23,14 +24,14 @@ bool RedisMgr::Get(const std::string& key, std::string& value)
 	}
 	auto reply = (redisReply*)redisCommand(connect, "GET %s", key.c_str());
 	if (reply == NULL) {
-		std::cout << "[ GET  " << key << " ] failed" << std::endl;
+		LOG_ERROR("[ GET  ", key, " ] failed");
 		// freeReplyObject(reply);
 		_con_pool->returnConnection(connect);
 		return false;
 	}
 
 	if (reply->type != REDIS_REPLY_STRING) {
-		std::cout << "[ GET  " << key << " ] failed" << std::endl;
+		LOG_WARN("[ GET  ", key, " ] failed");
 		freeReplyObject(reply);
 		_con_pool->returnConnection(connect);
 		return false;
@@ -39,12 +40,32 @@ bool RedisMgr::Get(const std::string& key, std::string& value)
 	value = reply->str;
 	freeReplyObject(reply);
 
-	std::cout << "Succeed to execute command [ GET " << key << "  ]" << std::endl;
-	std::cout << "Retrieved value: [" << value << "], length: " << value.length() << std::endl;  // 
+	LOG_DEBUG("Succeed to execute command [ GET ", key, "  ]");
+	LOG_DEBUG("Retrieved value: [", value, "], length: ", value.length());
 	_con_pool->returnConnection(connect);
 	return true;
 }
 
+net::awaitable<std::optional<std::string>> RedisMgr::AsyncGet(std::string key, TraceContext trace)
+{
+	// spanں̳߳Ŷӵʱ
+	Span span(trace, "redis GET", SpanKind::Client);
+	span.SetAttribute("db.system", "redis");
+	// Ȱ󶨵ֲco_awaitGCC 12co_awaitʽеlambdaʱλƽЭ֡stringᱻͷ
+	auto work = [this, key]() -> std::optional<std::string> {
+		std::string value;
+		if (!Get(key, value)) {
+			return std::nullopt;
+		}
+		return value;
+		};
+	auto value = co_await BackendExecutor::GetInstance()->Run(std::move(work));
+	if (!value) {
+		span.SetAttribute("redis.hit", static_cast<std::int64_t>(0));
+	}
+	co_return value;
+}
+
 bool RedisMgr::Set(const std::string& key, const std::string& value) {
 	//ִredis
 	auto connect = _con_pool->getConnection();
@@ -56,7 +77,7 @@ bool RedisMgr::Set(const std::string& key, const std::string& value) {
 	//NULL˵ִʧ
 	if (NULL == reply)
 	{
-		std::cout << "Execut command [ SET " << key << "  " << value << " ] failure ! " << std::endl;
+		LOG_WARN("Execut command [ SET ", key, "  ", value, " ] failure ! ");
 		//freeReplyObject(reply);
 		_con_pool->returnConnection(connect);
 		return false;
@@ -65,7 +86,7 @@ bool RedisMgr::Set(const std::string& key, const std::string& value) {
 	//ִʧͷ
 	if (!(reply->type == REDIS_REPLY_STATUS && (strcmp(reply->str, "OK") == 0 || strcmp(reply->str, "ok") == 0)))
 	{
-		std::cout << "Execut command [ SET " << key << "  " << value << " ] failure ! " << std::endl;
+		LOG_WARN("Execut command [ SET ", key, "  ", value, " ] failure ! ");
 		freeReplyObject(reply);
 		_con_pool->returnConnection(connect);
 		return false;
@@ -73,7 +94,34 @@ bool RedisMgr::Set(const std::string& key, const std::string& value) {
 
 	//ִгɹ ͷredisCommandִк󷵻صredisReplyռõڴ
 	freeReplyObject(reply);
-	std::cout << "Execut command [ SET " << key << "  " << value << " ] success ! " << std::endl;
+	LOG_DEBUG("Execut command [ SET ", key, "  ", value, " ] success ! ");
+	_con_pool->returnConnection(connect);
+	return true;
+}
+
+bool RedisMgr::SetExpire(const std::string& key, const std::string& value, int seconds) {
+	auto connect = _con_pool->getConnection();
+	if (connect == nullptr) {
+		return false;
+	}
+	auto reply = (redisReply*)redisCommand(connect, "SET %s %s EX %d", key.c_str(), value.c_str(), seconds);
+	if (NULL == reply)
+	{
+		LOG_WARN("Execut command [ SET ", key, "  ", value, " EX ", seconds, " ] failure ! ");
+		_con_pool->returnConnection(connect);
+		return false;
+	}
+
+	if (!(reply->type == REDIS_REPLY_STATUS && (strcmp(reply->str, "OK") == 0 || strcmp(reply->str, "ok") == 0)))
+	{
+		LOG_WARN("Execut command [ SET ", key, "  ", value, " EX ", seconds, " ] failure ! ");
+		freeReplyObject(reply);
+		_con_pool->returnConnection(connect);
+		return false;
+	}
+
+	freeReplyObject(reply);
+	LOG_DEBUG("Execut command [ SET ", key, "  ", value, " EX ", seconds, " ] success ! ");
 	_con_pool->returnConnection(connect);
 	return true;
 }
@@ -87,20 +135,20 @@ bool RedisMgr::LPush(const std::string& key, const std::string& value)
 	auto reply = (redisReply*)redisCommand(connect, "LPUSH %s %s", key.c_str(), value.c_str());
 	if (NULL == reply)
 	{
-		std::cout << "Execut command [ LPUSH " << key << "  " << value << " ] failure ! " << std::endl;
+		LOG_WARN("Execut command [ LPUSH ", key, "  ", value, " ] failure ! ");
 		freeReplyObject(reply);
 		_con_pool->returnConnection(connect);
 		return false;
 	}
 
 	if (reply->type != REDIS_REPLY_INTEGER || reply->integer <= 0) {
-		std::cout << "Execut command [ LPUSH " << key << "  " << value << " ] failure ! " << std::endl;
+		LOG_WARN("Execut command [ LPUSH ", key, "  ", value, " ] failure ! ");
 		freeReplyObject(reply);
 		_con_pool->returnConnection(connect);
 		return false;
 	}
 
-	std::cout << "Execut command [ LPUSH " << key << "  " << value << " ] success ! " << std::endl;
+	LOG_DEBUG("Execut command [ LPUSH ", key, "  ", value, " ] success ! ");
 	freeReplyObject(reply);
 	_con_pool->returnConnection(connect);
 	return true;
@@ -113,20 +161,20 @@ bool RedisMgr::LPop(const std::string& key, std::string& value) {
 	}
 	auto reply = (redisReply*)redisCommand(connect, "LPOP %s ", key.c_str());
 	if (reply == nullptr) {
-		std::cout << "Execut command [ LPOP " << key << " ] failure ! " << std::endl;
+		LOG_WARN("Execut command [ LPOP ", key, " ] failure ! ");
 		_con_pool->returnConnection(connect);
 		return false;
 	}
 
 	if (reply->type == REDIS_REPLY_NIL) {
-		std::cout << "Execut command [ LPOP " << key << " ] failure ! " << std::endl;
+		LOG_WARN("Execut command [ LPOP ", key, " ] failure ! ");
 		freeReplyObject(reply);
 		_con_pool->returnConnection(connect);
 		return false;
 	}
 
 	value = reply->str;
-	std::cout << "Execut command [ LPOP " << key << " ] success ! " << std::endl;
+	LOG_DEBUG("Execut command [ LPOP ", key, " ] success ! ");
 	freeReplyObject(reply);
 	_con_pool->returnConnection(connect);
 	return true;
@@ -140,20 +188,20 @@ bool RedisMgr::RPush(const std::string& key, const std::string& value) {
 	auto reply = (redisReply*)redisCommand(connect, "RPUSH %s %s", key.c_str(), value.c_str());
 	if (NULL == reply)
 	{
-		std::cout << "Execut command [ RPUSH " << key << "  " << value << " ] failure ! " << std::endl;
+		LOG_WARN("Execut command [ RPUSH ", key, "  ", value, " ] failure ! ");
 		freeReplyObject(reply);
 		_con_pool->returnConnection(connect);
 		return false;
 	}
 
 	if (reply->type != REDIS_REPLY_INTEGER || reply->integer <= 0) {
-		std::cout << "Execut command [ RPUSH " << key << "  " << value << " ] failure ! " << std::endl;
+		LOG_WARN("Execut command [ RPUSH ", key, "  ", value, " ] failure ! ");
 		freeReplyObject(reply);
 		_con_pool->returnConnection(connect);
 		return false;
 	}
 
-	std::cout << "Execut command [ RPUSH " << key << "  " << value << " ] success ! " << std::endl;
+	LOG_DEBUG("Execut command [ RPUSH ", key, "  ", value, " ] success ! ");
 	freeReplyObject(reply);
 	_con_pool->returnConnection(connect);
 	return true;
@@ -165,19 +213,19 @@ bool RedisMgr::RPop(const std::string& key, std::string& value) {
 	}
 	auto reply = (redisReply*)redisCommand(connect, "RPOP %s ", key.c_str());
 	if (reply == nullptr) {
-		std::cout << "Execut command [ RPOP " << key << " ] failure ! " << std::endl;
+		LOG_WARN("Execut command [ RPOP ", key, " ] failure ! ");
 		_con_pool->returnConnection(connect);
 		return false;
 	}
 
 	if (reply->type == REDIS_REPLY_NIL) {
-		std::cout << "Execut command [ RPOP " << key << " ] failure ! " << std::endl;
+		LOG_WARN("Execut command [ RPOP ", key, " ] failure ! ");
 		freeReplyObject(reply);
 		_con_pool->returnConnection(connect);
 		return false;
 	}
 	value = reply->str;
-	std::cout << "Execut command [ RPOP " << key << " ] success ! " << std::endl;
+	LOG_DEBUG("Execut command [ RPOP ", key, " ] success ! ");
 	freeReplyObject(reply);
 	_con_pool->returnConnection(connect);
 	return true;
@@ -190,19 +238,19 @@ bool RedisMgr::HSet(const std::string& key, const std::string& hkey, const std::
 	}
 	auto reply = (redisReply*)redisCommand(connect, "HSET %s %s %s", key.c_str(), hkey.c_str(), value.c_str());
 	if (reply == nullptr) {
-		std::cout << "Execut command [ HSet " << key << "  " << hkey << "  " << value << " ] failure ! " << std::endl;
+		LOG_WARN("Execut command [ HSet ", key, "  ", hkey, "  ", value, " ] failure ! ");
 		_con_pool->returnConnection(connect);
 		return false;
 	}
 
 	if (reply->type != REDIS_REPLY_INTEGER) {
-		std::cout << "Execut command [ HSet " << key << "  " << hkey << "  " << value << " ] failure ! " << std::endl;
+		LOG_WARN("Execut command [ HSet ", key, "  ", hkey, "  ", value, " ] failure ! ");
 		freeReplyObject(reply);
 		_con_pool->returnConnection(connect);
 		return false;
 	}
 
-	std::cout << "Execut command [ HSet " << key << "  " << hkey << "  " << value << " ] success ! " << std::endl;
+	LOG_DEBUG("Execut command [ HSet ", key, "  ", hkey, "  ", value, " ] success ! ");
 	freeReplyObject(reply);
 	_con_pool->returnConnection(connect);
 	return true;
@@ -227,18 +275,18 @@ bool RedisMgr::HSet(const char* key, const char* hkey, const char* hvalue, size_
 
 	auto reply = (redisReply*)redisCommandArgv(connect, 4, argv, argvlen);
 	if (reply == nullptr) {
-		std::cout << "Execut command [ HSet " << key << "  " << hkey << "  " << hvalue << " ] failure ! " << std::endl;
+		LOG_WARN("Execut command [ HSet ", key, "  ", hkey, "  ", hvalue, " ] failure ! ");
 		_con_pool->returnConnection(connect);
 		return false;
 	}
 
 	if (reply->type != REDIS_REPLY_INTEGER) {
-		std::cout << "Execut command [ HSet " << key << "  " << hkey << "  " << hvalue << " ] failure ! " << std::endl;
+		LOG_WARN("Execut command [ HSet ", key, "  ", hkey, "  ", hvalue, " ] failure ! ");
 		freeReplyObject(reply);
 		_con_pool->returnConnection(connect);
 		return false;
 	}
-	std::cout << "Execut command [ HSet " << key << "  " << hkey << "  " << hvalue << " ] success ! " << std::endl;
+	LOG_DEBUG("Execut command [ HSet ", key, "  ", hkey, "  ", hvalue, " ] success ! ");
 	freeReplyObject(reply);
 	_con_pool->returnConnection(connect);
 	return true;
@@ -261,14 +309,14 @@ std::string RedisMgr::HGet(const std::string& key, const std::string& hkey)
 
 	auto reply = (redisReply*)redisCommandArgv(connect, 3, argv, argvlen);
 	if (reply == nullptr) {
-		std::cout << "Execut command [ HGet " << key << " " << hkey << "  ] failure ! " << std::endl;
+		LOG_WARN("Execut command [ HGet ", key, " ", hkey, "  ] failure ! ");
 		_con_pool->returnConnection(connect);
 		return "";
 	}
 
 	if (reply->type == REDIS_REPLY_NIL) {
 		freeReplyObject(reply);
-		std::cout << "Execut command [ HGet " << key << " " << hkey << "  ] failure ! " << std::endl;
+		LOG_WARN("Execut command [ HGet ", key, " ", hkey, "  ] failure ! ");
 		_con_pool->returnConnection(connect);
 		return "";
 	}
@@ -276,7 +324,7 @@ std::string RedisMgr::HGet(const std::string& key, const std::string& hkey)
 	std::string value = reply->str;
 	freeReplyObject(reply);
 	_con_pool->returnConnection(connect);
-	std::cout << "Execut command [ HGet " << key << " " << hkey << " ] success ! " << std::endl;
+	LOG_DEBUG("Execut command [ HGet ", key, " ", hkey, " ] success ! ");
 	return value;
 }
 
@@ -289,7 +337,7 @@ bool RedisMgr::HDel(const std::string& key, const std::string& field)
 
 	redisReply* reply = (redisReply*)redisCommand(connect, "HDEL %s %s", key.c_str(), field.c_str());
 	if (reply == nullptr) {
-		std::cerr << "HDEL command failed" << std::endl;
+		LOG_ERROR("HDEL command failed");
 		_con_pool->returnConnection(connect);
 		return false;
 	}
@@ -312,19 +360,19 @@ bool RedisMgr::Del(const std::string& key)
 	}
 	auto reply = (redisReply*)redisCommand(connect, "DEL %s", key.c_str());
 	if (reply == nullptr) {
-		std::cout << "Execut command [ Del " << key << " ] failure ! " << std::endl;
+		LOG_WARN("Execut command [ Del ", key, " ] failure ! ");
 		_con_pool->returnConnection(connect);
 		return false;
 	}
 
 	if (reply->type != REDIS_REPLY_INTEGER) {
-		std::cout << "Execut command [ Del " << key << " ] failure ! " << std::endl;
+		LOG_WARN("Execut command [ Del ", key, " ] failure ! ");
 		freeReplyObject(reply);
 		_con_pool->returnConnection(connect);
 		return false;
 	}
 
-	std::cout << "Execut command [ Del " << key << " ] success ! " << std::endl;
+	LOG_DEBUG("Execut command [ Del ", key, " ] success ! ");
 	freeReplyObject(reply);
 	_con_pool->returnConnection(connect);
 	return true;
@@ -339,18 +387,18 @@ bool RedisMgr::ExistsKey(const std::string& key)
 
 	auto reply = (redisReply*)redisCommand(connect, "exists %s", key.c_str());
 	if (reply == nullptr) {
-		std::cout << "Not Found [ Key " << key << " ]  ! " << std::endl;
+		LOG_DEBUG("Not Found [ Key ", key, " ]  ! ");
 		_con_pool->returnConnection(connect);
 		return false;
 	}
 
 	if (reply->type != REDIS_REPLY_INTEGER || reply->integer == 0) {
-		std::cout << "Not Found [ Key " << key << " ]  ! " << std::endl;
+		LOG_DEBUG("Not Found [ Key ", key, " ]  ! ");
 		_con_pool->returnConnection(connect);
 		freeReplyObject(reply);
 		return false;
 	}
-	std::cout << " Found [ Key " << key << " ] exists ! " << std::endl;
+	LOG_DEBUG(" Found [ Key ", key, " ] exists ! ");
 	freeReplyObject(reply);
 	_con_pool->returnConnection(connect);
 	return true;
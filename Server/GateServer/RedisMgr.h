@@ -4,11 +4,18 @@
 #include <atomic>
 #include <mutex>
 #include "Singleton.h"
+#include "BackendExecutor.h"
 #include <cstring>
+#include <optional>
+#include <unordered_map>
+#include "PoolMetrics.h"
+#include "Tracer.h"
 class RedisConPool {
 public:
-	RedisConPool(size_t poolSize, const char* host, int port, const char* pwd)
-		: poolSize_(poolSize), host_(host), port_(port), b_stop_(false), pwd_(pwd), counter_(0), fail_count_(0) {
+	RedisConPool(size_t poolSize, const char* host, int port, const char* pwd,
+		std::chrono::milliseconds waitTimeout = std::chrono::milliseconds(0))
+		: poolSize_(poolSize), host_(host), port_(port), b_stop_(false), pwd_(pwd), counter_(0), fail_count_(0),
+		wait_timeout_(waitTimeout), metrics_("redis") {
 		for (size_t i = 0; i < poolSize_; ++i) {
 			auto* context = redisConnect(host, port);
 			if (context == nullptr || context->err != 0) {
@@ -20,7 +27,7 @@ public:
 
 			auto reply = (redisReply*)redisCommand(context, "AUTH %s", pwd);
 			if (reply->type == REDIS_REPLY_ERROR) {
-				std::cout << "֤ʧ" << std::endl;
+				LOG_ERROR("֤ʧ");
 				//ִгɹ ͷredisCommandִк󷵻صredisReplyռõڴ
 				freeReplyObject(reply);
 				continue;
@@ -28,9 +35,10 @@ public:
 
 			//ִгɹ ͷredisCommandִк󷵻صredisReplyռõڴ
 			freeReplyObject(reply);
-			std::cout << "֤ɹ" << std::endl;
+			LOG_DEBUG("֤ɹ");
 			connections_.push(context);
 		}
+		metrics_.SetIdle(connections_.size());
 
 		check_thread_ = std::thread([this]() {
 			while (!b_stop_) {
@@ -57,22 +65,36 @@ public:
 			redisFree(context);
 			connections_.pop();
 		}
+		metrics_.SetIdle(0);
 	}
 
+	// ˵ȴʱʱʱؿָ
 	redisContext* getConnection() {
+		auto wait_start = std::chrono::steady_clock::now();
 		std::unique_lock<std::mutex> lock(mutex_);
-		cond_.wait(lock, [this] {
+		auto ready = [this] {
 			if (b_stop_) {
 				return true;
 			}
 			return !connections_.empty();
-			});
+			};
+		if (wait_timeout_.count() > 0) {
+			if (!cond_.wait_for(lock, wait_timeout_, ready)) {
+				metrics_.OnTimeout();
+				return nullptr;
+			}
+		}
+		else {
+			cond_.wait(lock, ready);
+		}
 		//ֱֹͣӷؿָ
 		if (b_stop_) {
 			return  nullptr;
 		}
 		auto* context = connections_.front();
 		connections_.pop();
+		metrics_.SetIdle(connections_.size());
+		lent_[context] = metrics_.OnAcquire(wait_start);
 		return context;
 	}
 
@@ -88,15 +110,23 @@ public:
 
 		auto* context = connections_.front();
 		connections_.pop();
+		metrics_.SetIdle(connections_.size());
 		return context;
 	}
 
 	void returnConnection(redisContext* context) {
 		std::lock_guard<std::mutex> lock(mutex_);
+		// ߳ȡӲʱ
+		auto iter = lent_.find(context);
+		if (iter != lent_.end()) {
+			metrics_.OnRelease(iter->second);
+			lent_.erase(iter);
+		}
 		if (b_stop_) {
 			return;
 		}
 		connections_.push(context);
+		metrics_.SetIdle(connections_.size());
 		cond_.notify_one();
 	}
 
@@ -109,26 +139,29 @@ public:
 private:
 
 	bool  reconnect() {
-		auto context = redisConnect(host_, port_);
+		auto context = redisConnect(host_.c_str(), port_);
 		if (context == nullptr || context->err != 0) {
 			if (context != nullptr) {
 				redisFree(context);
 			}
+			metrics_.OnReconnect(false);
 			return false;
 		}
 
-		auto reply = (redisReply*)redisCommand(context, "AUTH %s", pwd_);
+		auto reply = (redisReply*)redisCommand(context, "AUTH %s", pwd_.c_str());
 		if (reply->type == REDIS_REPLY_ERROR) {
-			std::cout << "֤ʧ" << std::endl;
+			LOG_ERROR("֤ʧ");
 			//ִгɹ ͷredisCommandִк󷵻صredisReplyռõڴ
 			freeReplyObject(reply);
 			redisFree(context);
+			metrics_.OnReconnect(false);
 			return false;
 		}
 
 		//ִгɹ ͷredisCommandִк󷵻صredisReplyռõڴ
 		freeReplyObject(reply);
-		std::cout << "֤ɹ" << std::endl;
+		LOG_DEBUG("֤ɹ");
+		metrics_.OnReconnect(true);
 		returnConnection(context);
 		return true;
 	}
@@ -156,7 +189,7 @@ private:
 				reply = (redisReply*)redisCommand(context, "PING");
 				// 2. ȿײ I/OЭûд
 				if (context->err) {
-					std::cout << "Connection error: " << context->err << std::endl;
+					LOG_ERROR("Connection error: ", context->err);
 					if (reply) {
 						freeReplyObject(reply);
 					}
@@ -167,7 +200,7 @@ private:
 
 				// 3. ٿ Redis صǲ ERROR
 				if (!reply || reply->type == REDIS_REPLY_ERROR) {
-					std::cout << "reply is null, redis ping failed: " << std::endl;
+					LOG_ERROR("reply is null, redis ping failed: ");
 					if (reply) {
 						freeReplyObject(reply);
 					}
@@ -217,7 +250,7 @@ private:
 			try {
 				auto reply = (redisReply*)redisCommand(context, "PING");
 				if (!reply) {
-					std::cout << "reply is null, redis ping failed: " << std::endl;
+					LOG_ERROR("reply is null, redis ping failed: ");
 					connections_.push(context);
 					continue;
 				}
@@ -225,9 +258,9 @@ private:
 				connections_.push(context);
 			}
 			catch (std::exception& exp) {
-				std::cout << "Error keeping connection alive: " << exp.what() << std::endl;
+				LOG_ERROR("Error keeping connection alive: ", exp.what());
 				redisFree(context);
-				context = redisConnect(host_, port_);
+				context = redisConnect(host_.c_str(), port_);
 				if (context == nullptr || context->err != 0) {
 					if (context != nullptr) {
 						redisFree(context);
@@ -235,9 +268,9 @@ private:
 					continue;
 				}
 
-				auto reply = (redisReply*)redisCommand(context, "AUTH %s", pwd_);
+				auto reply = (redisReply*)redisCommand(context, "AUTH %s", pwd_.c_str());
 				if (reply->type == REDIS_REPLY_ERROR) {
-					std::cout << "֤ʧ" << std::endl;
+					LOG_ERROR("֤ʧ");
 					//ִгɹ ͷredisCommandִк󷵻صredisReplyռõڴ
 					freeReplyObject(reply);
 					continue;
@@ -245,15 +278,16 @@ private:
 
 				//ִгɹ ͷredisCommandִк󷵻صredisReplyռõڴ
 				freeReplyObject(reply);
-				std::cout << "֤ɹ" << std::endl;
+				LOG_DEBUG("֤ɹ");
 				connections_.push(context);
 			}
 		}
 	}
 	std::atomic<bool> b_stop_;
 	size_t poolSize_;
-	const char* host_;
-	const char* pwd_;
+	// ʱʱַʱҪã渱
+	std::string host_;
+	std::string pwd_;
 	int port_;
 	std::queue<redisContext*> connections_;
 	std::atomic<int> fail_count_;
@@ -261,6 +295,9 @@ private:
 	std::condition_variable cond_;
 	std::thread  check_thread_;
 	int counter_;
+	std::chrono::milliseconds wait_timeout_;				// ȡӵĵȴʱ0ʾһֱȴ
+	PoolMetrics metrics_;
+	std::unordered_map<redisContext*, PoolMetrics::TimePoint> lent_;	// Ӻͽʱ
 };
 
 class RedisMgr : public Singleton<RedisMgr>,
@@ -270,7 +307,11 @@ class RedisMgr : public Singleton<RedisMgr>,
 public:
 	~RedisMgr();
 	bool Get(const std::string& key, std::string& value);
+	// Э̰汾Getںִ̳߳Уkeyڻʱؿ
+	net::awaitable<std::optional<std::string>> AsyncGet(std::string key, TraceContext trace = {});
 	bool Set(const std::string& key, const std::string& value);
+	// SET key value EX secondsVerifyServerеSetRedisExpireһ
+	bool SetExpire(const std::string& key, const std::string& value, int seconds);
 	bool LPush(const std::string& key, const std::string& value);
 	bool LPop(const std::string& key, std::string& value);
 	bool RPush(const std::string& key, const std::string& value);
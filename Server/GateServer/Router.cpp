@@ -0,0 +1,195 @@
+#include "Router.h"
+#include <stdexcept>
+
+namespace {
+	const char* const METHOD_NAMES[] = { "GET", "POST", "PUT", "DELETE", "PATCH", "HEAD", "OPTIONS" };
+}
+
+Router::Node::Node()
+{
+	handlers.fill(NO_HANDLER);
+}
+
+unsigned Router::Node::AllowedMask() const
+{
+	unsigned mask = 0;
+	for (std::size_t i = 0; i < METHOD_COUNT; ++i) {
+		if (handlers[i] != NO_HANDLER) {
+			mask |= 1u << i;
+		}
+	}
+	return mask;
+}
+
+Router::Router() : _root(std::make_unique<Node>())
+{
+
+}
+
+Router::~Router() = default;
+
+int Router::MethodSlot(http::verb method)
+{
+	switch (method) {
+	case http::verb::get:		return 0;
+	case http::verb::post:		return 1;
+	case http::verb::put:		return 2;
+	case http::verb::delete_:	return 3;
+	case http::verb::patch:		return 4;
+	case http::verb::head:		return 5;
+	case http::verb::options:	return 6;
+	default:					return -1;
+	}
+}
+
+std::string Router::AllowHeader(unsigned allowed)
+{
+	std::string header;
+	for (std::size_t i = 0; i < METHOD_COUNT; ++i) {
+		if (allowed & (1u << i)) {
+			if (!header.empty()) {
+				header += ", ";
+			}
+			header += METHOD_NAMES[i];
+		}
+	}
+	return header;
+}
+
+void Router::Add(http::verb method, std::string_view pattern, std::size_t handler_id)
+{
+	int slot = MethodSlot(method);
+	if (slot < 0) {
+		throw std::invalid_argument("unsupported method for route " + std::string(pattern));
+	}
+
+	Node* node = _root.get();
+	std::size_t pos = 0;
+	while (pos < pattern.size()) {
+		auto open = pattern.find('{', pos);
+		if (open == std::string_view::npos) {
+			node = InsertStatic(node, pattern.substr(pos));
+			break;
+		}
+		if (open > pos) {
+			node = InsertStatic(node, pattern.substr(pos, open - pos));
+		}
+
+		auto close = pattern.find('}', open);
+		if (close == std::string_view::npos) {
+			throw std::invalid_argument("unclosed parameter in route " + std::string(pattern));
+		}
+		auto name = pattern.substr(open + 1, close - open - 1);
+		if (!node->param_child) {
+			node->param_child = std::make_unique<Node>();
+			node->param_child->param_name = std::string(name);
+		}
+		else if (node->param_child->param_name != name) {
+			// ͬһλֻһƥ
+			throw std::invalid_argument("conflicting parameter name in route " + std::string(pattern));
+		}
+		node = node->param_child.get();
+		pos = close + 1;
+	}
+
+	node->handlers[slot] = handler_id;
+}
+
+Router::Node* Router::InsertStatic(Node* node, std::string_view text)
+{
+	while (!text.empty()) {
+		std::unique_ptr<Node>* slot = nullptr;
+		for (auto& child : node->children) {
+			if (child->prefix[0] == text[0]) {
+				slot = &child;
+				break;
+			}
+		}
+
+		if (slot == nullptr) {
+			auto child = std::make_unique<Node>();
+			child->prefix = std::string(text);
+			node->children.push_back(std::move(child));
+			return node->children.back().get();
+		}
+
+		// 㹫ǰ׺ȫغʱнڵ
+		Node* child = slot->get();
+		std::size_t common = 0;
+		while (common < child->prefix.size() && common < text.size()
+			&& child->prefix[common] == text[common]) {
+			++common;
+		}
+		if (common < child->prefix.size()) {
+			auto middle = std::make_unique<Node>();
+			middle->prefix = child->prefix.substr(0, common);
+			child->prefix.erase(0, common);
+			middle->children.push_back(std::move(*slot));
+			*slot = std::move(middle);
+			child = slot->get();
+		}
+
+		text.remove_prefix(common);
+		node = child;
+	}
+	return node;
+}
+
+RouteStatus Router::Match(http::verb method, std::string_view path,
+	std::size_t& handler_id, PathParams& params, unsigned& allowed) const
+{
+	params.clear();
+	const Node* matched = nullptr;
+	if (!MatchNode(_root.get(), path, params, matched)) {
+		params.clear();
+		return RouteStatus::NotFound;
+	}
+
+	int slot = MethodSlot(method);
+	if (slot >= 0 && matched->handlers[slot] != NO_HANDLER) {
+		handler_id = matched->handlers[slot];
+		return RouteStatus::Found;
+	}
+
+	allowed = matched->AllowedMask();
+	params.clear();
+	return RouteStatus::MethodNotAllowed;
+}
+
+bool Router::MatchNode(const Node* node, std::string_view path, PathParams& params,
+	const Node*& matched) const
+{
+	if (path.empty()) {
+		// мڵûעκη·
+		if (node->AllowedMask() == 0) {
+			return false;
+		}
+		matched = node;
+		return true;
+	}
+
+	// ̬·ȣӽڵַֻͬһѡ
+	for (const auto& child : node->children) {
+		if (child->prefix[0] != path[0]) {
+			continue;
+		}
+		if (path.substr(0, child->prefix.size()) == child->prefix
+			&& MatchNode(child.get(), path.substr(child->prefix.size()), params, matched)) {
+			return true;
+		}
+		break;
+	}
+
+	// ̬·ƥʧٳԲƥһ·
+	if (node->param_child) {
+		auto segment = path.substr(0, path.find('/'));
+		if (!segment.empty()) {
+			params.push_back(PathParam{ node->param_child->param_name, segment });
+			if (MatchNode(node->param_child.get(), path.substr(segment.size()), params, matched)) {
+				return true;
+			}
+			params.pop_back();
+		}
+	}
+	return false;
+}
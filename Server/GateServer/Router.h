@@ -0,0 +1,64 @@
+#pragma once
+#include "const.h"
+#include <array>
+#include <string_view>
+#include <vector>
+
+// ·ƥ
+enum class RouteStatus {
+	Found,				// ·ͷƥ
+	MethodNotAllowed,	// ·ڣûע÷ظ405
+	NotFound,			// ·ڣظ404
+};
+
+// ·/user/{uid}еuid
+// nameָ·ɱvalueָtargetֻڱڼЧ
+struct PathParam {
+	std::string_view name;
+	std::string_view value;
+};
+typedef std::vector<PathParam> PathParams;
+
+// ·ɣעʱƥʱֻ·string_viewȽϣַ
+// ƥ俪ֻ·йأע·޹ء
+// ·ֻ׶עᣬֻ֮io߳̿ͬʱƥ
+class Router
+{
+public:
+	Router();
+	~Router();
+	Router(const Router&) = delete;
+	Router& operator=(const Router&) = delete;
+
+	// ע·ɣpattern{name}ʾƥһ·Ĳhandler_idɵ÷Լ
+	void Add(http::verb method, std::string_view pattern, std::size_t handler_id);
+
+	// ƥɹʱhandler_idparams405ʱallowedΪ·ע᷽λ
+	RouteStatus Match(http::verb method, std::string_view path,
+		std::size_t& handler_id, PathParams& params, unsigned& allowed) const;
+
+	// allowedλתAllowͷ"GET, POST"
+	static std::string AllowHeader(unsigned allowed);
+
+private:
+	static constexpr std::size_t METHOD_COUNT = 7;
+	static constexpr std::size_t NO_HANDLER = static_cast<std::size_t>(-1);
+
+	struct Node {
+		std::string prefix;							// ̬ڵѹ·Ƭ
+		std::vector<std::unique_ptr<Node>> children;	// ̬ӽڵ㣬ַͬ
+		std::unique_ptr<Node> param_child;			// ӽڵ㣬ƥ䵽һ'/'Ϊֹ
+		std::string param_name;						// ڵĲ
+		std::array<std::size_t, METHOD_COUNT> handlers;	// ÿӦĴ±
+
+		Node();
+		unsigned AllowedMask() const;
+	};
+
+	static int MethodSlot(http::verb method);
+	Node* InsertStatic(Node* node, std::string_view text);
+	bool MatchNode(const Node* node, std::string_view path, PathParams& params,
+		const Node*& matched) const;
+
+	std::unique_ptr<Node> _root;
+};
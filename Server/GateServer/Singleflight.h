@@ -0,0 +1,161 @@
+#pragma once
+#include "const.h"
+#include "Metrics.h"
+#include "BackendExecutor.h"
+#include <chrono>
+#include <deque>
+#include <exception>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// keyϲͬʱеͬãͬһkeyͬʱֻһִУleader
+// Э̹ͬһkeepĽٻcache_ttlڼظֱӷػ
+// ȴ߿ڲͬio_contextϣͶݻظЭ̵ִ
+template <typename Result>
+class Singleflight
+{
+public:
+	// nameָıǩcache_ttlΪ0ʱ棬ֻϲ;
+	Singleflight(const std::string& name, std::chrono::milliseconds cache_ttl)
+		: _cache_ttl(cache_ttl)
+		, _joined(Metrics::Inst().GetCounter("gate_singleflight_joined_total",
+			"Calls that waited on an identical call already in flight", "name=\"" + name + "\""))
+		, _cache_hits(Metrics::Inst().GetCounter("gate_singleflight_cache_hits_total",
+			"Calls answered from the short-lived result cache", "name=\"" + name + "\"")) {
+	}
+	Singleflight(const Singleflight&) = delete;
+	Singleflight& operator=(const Singleflight&) = delete;
+
+	typedef std::function<net::awaitable<Result>()> Call;
+	typedef std::function<bool(const Result&)> Keep;
+
+	// ֻleadercallkeep(result)ΪtrueĽŽ棬ֻɹӦ
+	net::awaitable<Result> Do(const std::string& key, Call call, Keep keep);
+
+private:
+	typedef std::chrono::steady_clock Clock;
+	typedef std::function<void(std::exception_ptr, Result)> Waiter;
+
+	struct Flight {
+		bool done = false;
+		std::exception_ptr error;
+		Result result{};
+		std::vector<Waiter> waiters;
+	};
+
+	struct CacheEntry {
+		Result result;
+		Clock::time_point expires;
+	};
+
+	// ȴ߹flightϣleaderʱָ
+	net::awaitable<Result> Wait(std::shared_ptr<Flight> flight);
+	// _mutexڵãڵĻٲ룬TTL̶԰˳ǰ˳
+	void CacheLocked(const std::string& key, const Result& result, Clock::time_point now);
+
+	std::chrono::milliseconds _cache_ttl;
+	std::mutex _mutex;
+	std::unordered_map<std::string, std::shared_ptr<Flight>> _flights;
+	std::unordered_map<std::string, CacheEntry> _cache;
+	std::deque<std::pair<std::string, Clock::time_point>> _expiry;
+	Counter& _joined;
+	Counter& _cache_hits;
+};
+
+template <typename Result>
+net::awaitable<Result> Singleflight<Result>::Do(const std::string& key, Call call, Keep keep)
+{
+	std::shared_ptr<Flight> flight;
+	bool leader = false;
+	bool cache_hit = false;
+	Result result{};
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		auto cached = _cache.find(key);
+		if (cached != _cache.end() && Clock::now() < cached->second.expires) {
+			result = cached->second.result;
+			cache_hit = true;
+		}
+		else {
+			auto& slot = _flights[key];
+			if (!slot) {
+				slot = std::make_shared<Flight>();
+				leader = true;
+			}
+			flight = slot;
+		}
+	}
+
+	if (cache_hit) {
+		_cache_hits.Inc();
+	}
+	else if (!leader) {
+		_joined.Inc();
+		result = co_await Wait(flight);
+	}
+	else {
+		std::exception_ptr error;
+		try {
+			result = co_await call();
+		}
+		catch (...) {
+			error = std::current_exception();
+		}
+		std::vector<Waiter> waiters;
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_flights.erase(key);
+			flight->done = true;
+			flight->error = error;
+			flight->result = result;
+			waiters.swap(flight->waiters);
+			if (!error && _cache_ttl.count() > 0 && keep(result)) {
+				CacheLocked(key, result, Clock::now());
+			}
+		}
+		for (auto& waiter : waiters) {
+			waiter(error, result);
+		}
+		if (error) {
+			std::rethrow_exception(error);
+		}
+	}
+	co_return result;
+}
+
+template <typename Result>
+net::awaitable<Result> Singleflight<Result>::Wait(std::shared_ptr<Flight> flight)
+{
+	auto executor = co_await net::this_coro::executor;
+	Result result = co_await net::async_initiate<const net::use_awaitable_t<>&, void(std::exception_ptr, Result)>(
+		[this, executor, &flight](auto handler) {
+			// leaderԼִϵwaiterȴ߻صԵִϻָ
+			Waiter waiter = MakeResumer(executor, std::move(handler));
+			std::unique_lock<std::mutex> lock(_mutex);
+			if (!flight->done) {
+				flight->waiters.push_back(std::move(waiter));
+				return;
+			}
+			// ֮leaderѾ
+			lock.unlock();
+			waiter(flight->error, flight->result);
+		}, net::use_awaitable);
+	co_return result;
+}
+
+template <typename Result>
+void Singleflight<Result>::CacheLocked(const std::string& key, const Result& result, Clock::time_point now)
+{
+	while (!_expiry.empty() && _expiry.front().second <= now) {
+		auto cached = _cache.find(_expiry.front().first);
+		// ͬһkeyֻ֮ģһΪ׼
+		if (cached != _cache.end() && cached->second.expires == _expiry.front().second) {
+			_cache.erase(cached);
+		}
+		_expiry.pop_front();
+	}
+	auto expires = now + _cache_ttl;
+	_cache[key] = CacheEntry{ result, expires };
+	_expiry.emplace_back(key, expires);
+}
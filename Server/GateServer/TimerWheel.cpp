@@ -0,0 +1,177 @@
+#include "TimerWheel.h"
+
+void TimerWheel::Timer::Cancel()
+{
+	if (_slot != nullptr) {
+		TimerWheel::Unlink(*this);
+	}
+}
+
+TimerWheel::TimerWheel(boost::asio::io_context& ioc, std::chrono::milliseconds tick)
+	: _driver(ioc), _tick(tick)
+{
+
+}
+
+TimerWheel::~TimerWheel()
+{
+	// ʱڶʱʱʣĶʱժʱͷŵĲλ
+	for (auto& slot : _near) {
+		while (slot != nullptr) {
+			Unlink(*slot);
+		}
+	}
+	for (auto& level : _levels) {
+		for (auto& slot : level) {
+			while (slot != nullptr) {
+				Unlink(*slot);
+			}
+		}
+	}
+}
+
+void TimerWheel::Start()
+{
+	_running = true;
+	_last_tick_time = std::chrono::steady_clock::now();
+	Schedule();
+}
+
+void TimerWheel::Stop()
+{
+	_running = false;
+	_driver.cancel();
+}
+
+void TimerWheel::Arm(Timer& timer, std::chrono::milliseconds timeout, std::function<void()> callback)
+{
+	timer.Cancel();
+	// ȡһtick
+	std::uint64_t ticks = (timeout.count() + _tick.count() - 1) / _tick.count();
+	if (ticks == 0) {
+		ticks = 1;
+	}
+	timer._expire = _current + ticks;
+	timer._callback = std::move(callback);
+	Place(timer);
+}
+
+void TimerWheel::Schedule()
+{
+	_driver.expires_at(_last_tick_time + _tick);
+	_driver.async_wait([this](const boost::system::error_code& ec) {
+		if (ec || !_running) {
+			return;
+		}
+		OnTick();
+		});
+}
+
+void TimerWheel::OnTick()
+{
+	// ʵŵʱƽio̱߳ʱһβµtick
+	auto now = std::chrono::steady_clock::now();
+	auto elapsed = (now - _last_tick_time) / _tick;
+	for (decltype(elapsed) i = 0; i < elapsed; ++i) {
+		Advance();
+	}
+	_last_tick_time += _tick * elapsed;
+	Schedule();
+}
+
+void TimerWheel::Advance()
+{
+	std::uint64_t index = _current & NEAR_MASK;
+	// һȦ꣬һӦλĶʱ·䵽²
+	if (index == 0) {
+		for (int level = 0; level < LEVELS; ++level) {
+			if (Cascade(level, (_current >> (NEAR_BITS + level * LEVEL_BITS)) & LEVEL_MASK) != 0) {
+				break;
+			}
+		}
+	}
+	++_current;
+
+	// ȰѵڵժֲͷִлصصArmĶʱͬһλ
+	// NEAR_SIZE-1tickڱtickժµĶʱȻھֲϣ
+	// صCancelͬһʱճЧ
+	Timer* expired = _near[index];
+	_near[index] = nullptr;
+	for (Timer* timer = expired; timer != nullptr; timer = timer->_next) {
+		timer->_slot = &expired;
+	}
+	while (Timer* timer = expired) {
+		Unlink(*timer);
+		auto callback = std::move(timer->_callback);
+		if (callback) {
+			callback();
+		}
+	}
+}
+
+void TimerWheel::Place(Timer& timer)
+{
+	std::uint64_t expire = timer._expire;
+	if (expire < _current) {
+		// Ѿڵķŵǰλһtick
+		Link(&_near[_current & NEAR_MASK], timer);
+		return;
+	}
+
+	std::uint64_t delta = expire - _current;
+	if (delta < NEAR_SIZE) {
+		Link(&_near[expire & NEAR_MASK], timer);
+		return;
+	}
+
+	if (delta > MAX_DELTA) {
+		expire = _current + MAX_DELTA;
+		timer._expire = expire;
+		delta = MAX_DELTA;
+	}
+
+	for (int level = 0; level < LEVELS; ++level) {
+		int shift = NEAR_BITS + (level + 1) * LEVEL_BITS;
+		if (level == LEVELS - 1 || delta < (1ull << shift)) {
+			Link(&_levels[level][(expire >> (shift - LEVEL_BITS)) & LEVEL_MASK], timer);
+			return;
+		}
+	}
+}
+
+std::uint64_t TimerWheel::Cascade(int level, std::uint64_t index)
+{
+	Timer*& slot = _levels[level][index];
+	while (Timer* timer = slot) {
+		Unlink(*timer);
+		Place(*timer);
+	}
+	return index;
+}
+
+void TimerWheel::Link(Timer** slot, Timer& timer)
+{
+	timer._slot = slot;
+	timer._prev = nullptr;
+	timer._next = *slot;
+	if (*slot != nullptr) {
+		(*slot)->_prev = &timer;
+	}
+	*slot = &timer;
+}
+
+void TimerWheel::Unlink(Timer& timer)
+{
+	if (timer._prev != nullptr) {
+		timer._prev->_next = timer._next;
+	}
+	else {
+		*timer._slot = timer._next;
+	}
+	if (timer._next != nullptr) {
+		timer._next->_prev = timer._prev;
+	}
+	timer._slot = nullptr;
+	timer._prev = nullptr;
+	timer._next = nullptr;
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <boost/asio.hpp>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+
+// ֲʱ֣οLinuxںtimerʵ֣
+// ÿio_contextӵһʱ֣һsteady_timer̶tick
+// Arm/CancelΪO(1)нӿֻio_context߳ϵ
+class TimerWheel
+{
+public:
+	// Ƕ뵽ʹ߶еĶʱڵ㣬ʱԶʱժ
+	class Timer {
+		friend class TimerWheel;
+	public:
+		Timer() = default;
+		~Timer() { Cancel(); }
+		Timer(const Timer&) = delete;
+		Timer& operator=(const Timer&) = delete;
+
+		// ȡʱδʱʱʲô
+		void Cancel();
+		// Ƿڵȴ
+		bool Pending() const { return _slot != nullptr; }
+
+	private:
+		Timer** _slot = nullptr;		// ڲλͷ
+		Timer* _prev = nullptr;
+		Timer* _next = nullptr;
+		std::uint64_t _expire = 0;		// ڵtick
+		std::function<void()> _callback;
+	};
+
+	explicit TimerWheel(boost::asio::io_context& ioc,
+		std::chrono::milliseconds tick = std::chrono::milliseconds(100));
+	~TimerWheel();
+	TimerWheel(const TimerWheel&) = delete;
+	TimerWheel& operator=(const TimerWheel&) = delete;
+
+	// /ֹͣtick
+	void Start();
+	void Stop();
+
+	// ϶ʱtimeoutioִ߳callbackѹϵĻȱȡ
+	void Arm(Timer& timer, std::chrono::milliseconds timeout, std::function<void()> callback);
+
+private:
+	static constexpr int NEAR_BITS = 8;
+	static constexpr int LEVEL_BITS = 6;
+	static constexpr std::uint64_t NEAR_SIZE = 1ull << NEAR_BITS;
+	static constexpr std::uint64_t LEVEL_SIZE = 1ull << LEVEL_BITS;
+	static constexpr std::uint64_t NEAR_MASK = NEAR_SIZE - 1;
+	static constexpr std::uint64_t LEVEL_MASK = LEVEL_SIZE - 1;
+	static constexpr int LEVELS = 3;
+	// ʱܱʾİֵ
+	static constexpr std::uint64_t MAX_DELTA = (1ull << (NEAR_BITS + LEVELS * LEVEL_BITS)) - 1;
+
+	void Schedule();
+	void OnTick();
+	void Advance();
+	void Place(Timer& timer);
+	std::uint64_t Cascade(int level, std::uint64_t index);
+	static void Link(Timer** slot, Timer& timer);
+	static void Unlink(Timer& timer);
+
+	boost::asio::steady_timer _driver;
+	std::chrono::milliseconds _tick;
+	std::chrono::steady_clock::time_point _last_tick_time;
+	std::uint64_t _current = 0;			// ǰtick
+	bool _running = false;
+
+	Timer* _near[NEAR_SIZE] = {};		// 256tick
+	Timer* _levels[LEVELS][LEVEL_SIZE] = {};	// Զtick㼶ţǰ
+};
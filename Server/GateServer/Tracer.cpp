@@ -0,0 +1,406 @@
+#include "Tracer.h"
+#include "ConfigMgr.h"
+#include "JsonWriter.h"
+#include "Logger.h"
+#include <chrono>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+struct Span::Data {
+	std::string name;
+	SpanKind kind = SpanKind::Internal;
+	std::uint64_t parent_id = 0;
+	std::int64_t start_ns = 0;
+	std::int64_t end_ns = 0;
+	std::vector<std::pair<std::string, std::string>> attributes;
+	std::vector<std::pair<std::string, std::int64_t>> int_attributes;
+	bool error = false;
+	std::string error_message;
+	TraceContext context;
+};
+
+namespace {
+	thread_local TraceContext t_current;
+
+	// ÿ߳һxorshiftidͲ
+	std::uint64_t NextRandom() {
+		thread_local std::uint64_t state = []() {
+			std::random_device rd;
+			std::uint64_t seed = (static_cast<std::uint64_t>(rd()) << 32) ^ rd();
+			return seed ? seed : 0x9E3779B97F4A7C15ull;
+		}();
+		state ^= state << 13;
+		state ^= state >> 7;
+		state ^= state << 17;
+		return state;
+	}
+
+	std::uint64_t NextId() {
+		std::uint64_t id = 0;
+		while (id == 0) {
+			id = NextRandom();
+		}
+		return id;
+	}
+
+	std::int64_t NowNanos() {
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::system_clock::now().time_since_epoch()).count();
+	}
+
+	const char HEX[] = "0123456789abcdef";
+
+	void AppendHex(std::string& out, const std::uint8_t* data, std::size_t len) {
+		for (std::size_t i = 0; i < len; ++i) {
+			out.push_back(HEX[data[i] >> 4]);
+			out.push_back(HEX[data[i] & 0x0F]);
+		}
+	}
+
+	std::string IdHex(std::uint64_t id) {
+		std::uint8_t bytes[8];
+		for (int i = 7; i >= 0; --i) {
+			bytes[i] = static_cast<std::uint8_t>(id & 0xFF);
+			id >>= 8;
+		}
+		std::string out;
+		AppendHex(out, bytes, sizeof(bytes));
+		return out;
+	}
+
+	bool ParseHex(std::string_view text, std::uint8_t* out) {
+		auto value = [](char c) -> int {
+			if (c >= '0' && c <= '9') return c - '0';
+			if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+			return -1;
+		};
+		for (std::size_t i = 0; i < text.size() / 2; ++i) {
+			int hi = value(text[2 * i]);
+			int lo = value(text[2 * i + 1]);
+			if (hi < 0 || lo < 0) {
+				return false;
+			}
+			out[i] = static_cast<std::uint8_t>((hi << 4) | lo);
+		}
+		return true;
+	}
+}
+
+bool TraceContext::Valid() const
+{
+	for (auto b : trace_id) {
+		if (b != 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+std::string TraceContext::ToTraceParent() const
+{
+	std::string out = "00-";
+	AppendHex(out, trace_id.data(), trace_id.size());
+	out.push_back('-');
+	out.append(IdHex(span_id));
+	out.append(sampled ? "-01" : "-00");
+	return out;
+}
+
+bool TraceContext::FromTraceParent(std::string_view header, TraceContext& context)
+{
+	// 00-0af7651916cd43dd8448eb211c80319c-b7ad6b7169203331-01
+	if (header.size() < 55 || header[2] != '-' || header[35] != '-' || header[52] != '-') {
+		return false;
+	}
+	// 汾0055ַ߰汾ں׷ֶΣҪ'-'ָ
+	std::string_view version = header.substr(0, 2);
+	if (version == "ff") {
+		return false;
+	}
+	if (version == "00" ? header.size() != 55 : header.size() > 55 && header[55] != '-') {
+		return false;
+	}
+	TraceContext parsed;
+	std::uint8_t version_byte = 0;
+	std::uint8_t span_bytes[8];
+	std::uint8_t flags = 0;
+	if (!ParseHex(version, &version_byte)
+		|| !ParseHex(header.substr(3, 32), parsed.trace_id.data())
+		|| !ParseHex(header.substr(36, 16), span_bytes)
+		|| !ParseHex(header.substr(53, 2), &flags)) {
+		return false;
+	}
+	for (auto b : span_bytes) {
+		parsed.span_id = (parsed.span_id << 8) | b;
+	}
+	if (!parsed.Valid() || parsed.span_id == 0) {
+		return false;
+	}
+	parsed.sampled = (flags & 0x01) != 0;
+	context = parsed;
+	return true;
+}
+
+Span::Span(const TraceContext& parent, std::string_view name, SpanKind kind)
+{
+	_context = parent;
+	if (!parent.sampled) {
+		return;
+	}
+	_context.span_id = NextId();
+	_data = std::make_unique<Data>();
+	_data->name.assign(name.data(), name.size());
+	_data->kind = kind;
+	_data->parent_id = parent.span_id;
+	_data->start_ns = NowNanos();
+}
+
+Span::Span() = default;
+
+Span::~Span()
+{
+	End();
+}
+
+Span::Span(Span&& other) noexcept
+	: _context(other._context), _data(std::move(other._data))
+{
+
+}
+
+Span& Span::operator=(Span&& other) noexcept
+{
+	if (this != &other) {
+		End();
+		_context = other._context;
+		_data = std::move(other._data);
+	}
+	return *this;
+}
+
+void Span::SetName(std::string_view name)
+{
+	if (_data) {
+		_data->name.assign(name.data(), name.size());
+	}
+}
+
+void Span::SetAttribute(std::string_view key, std::string_view value)
+{
+	if (_data) {
+		_data->attributes.emplace_back(std::string(key), std::string(value));
+	}
+}
+
+void Span::SetAttribute(std::string_view key, std::int64_t value)
+{
+	if (_data) {
+		_data->int_attributes.emplace_back(std::string(key), value);
+	}
+}
+
+void Span::SetError(std::string_view message)
+{
+	if (_data) {
+		_data->error = true;
+		_data->error_message.assign(message.data(), message.size());
+	}
+}
+
+void Span::End()
+{
+	if (!_data) {
+		return;
+	}
+	_data->end_ns = NowNanos();
+	_data->context = _context;
+	Tracer::Inst().Submit(std::move(_data));
+}
+
+Tracer& Tracer::Inst()
+{
+	static Tracer* tracer = new Tracer();
+	return *tracer;
+}
+
+Tracer::Tracer()
+{
+	auto section = ConfigMgr::Inst()["Trace"];
+	// һ쳣ʽʱ0
+	std::string rate = section["SampleRate"];
+	_sample_rate = std::strtod(rate.c_str(), nullptr);
+	_sample_rate = std::clamp(_sample_rate, 0.0, 1.0);
+	std::string trust_parent = section["TrustParent"];
+	_trust_parent = trust_parent == "true" || trust_parent == "1";
+	std::string max_file_size = section["MaxFileSize"];
+	_max_file_size = max_file_size.empty() ? 100 * 1024 * 1024
+		: static_cast<long>(atoi(max_file_size.c_str())) * 1024 * 1024;
+	_file = section["File"];
+	if (_file.empty()) {
+		_file = "trace.json";
+	}
+	_exporter = std::thread([this]() {
+		Run();
+		});
+}
+
+Span Tracer::StartRequest(std::string_view traceparent, std::string_view name)
+{
+	TraceContext parent;
+	bool has_parent = !traceparent.empty() && TraceContext::FromTraceParent(traceparent, parent);
+	if (has_parent && !_trust_parent) {
+		// εĲ־κοͻ˶ÿ󶼱trace_idǷز
+		parent.sampled = _sample_rate > 0 && static_cast<double>(NextRandom() >> 11) * 0x1.0p-53 < _sample_rate;
+	}
+	if (!has_parent) {
+		// ûʱԼǷtrace_id
+		if (_sample_rate <= 0 || static_cast<double>(NextRandom() >> 11) * 0x1.0p-53 >= _sample_rate) {
+			return Span();
+		}
+		std::uint64_t high = NextId();
+		std::uint64_t low = NextId();
+		for (int i = 0; i < 8; ++i) {
+			parent.trace_id[i] = static_cast<std::uint8_t>(high >> (56 - 8 * i));
+			parent.trace_id[8 + i] = static_cast<std::uint8_t>(low >> (56 - 8 * i));
+		}
+		parent.span_id = 0;
+		parent.sampled = true;
+	}
+	return Span(parent, name, SpanKind::Server);
+}
+
+const TraceContext& Tracer::Current()
+{
+	return t_current;
+}
+
+Tracer::ScopedContext::ScopedContext(const TraceContext& context)
+	: _saved(t_current)
+{
+	t_current = context;
+}
+
+Tracer::ScopedContext::~ScopedContext()
+{
+	t_current = _saved;
+}
+
+void Tracer::Submit(std::unique_ptr<Span::Data> span)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (_pending.size() >= MAX_PENDING) {
+		_dropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+	_pending.push_back(std::move(span));
+	if (_pending.size() >= BATCH_SIZE) {
+		_cond.notify_one();
+	}
+}
+
+void Tracer::Run()
+{
+	std::vector<std::unique_ptr<Span::Data>> batch;
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_cond.wait_for(lock, std::chrono::seconds(1), [this]() {
+				return _stop.load() || _pending.size() >= BATCH_SIZE;
+				});
+			batch.swap(_pending);
+		}
+		if (!batch.empty()) {
+			Export(batch);
+			batch.clear();
+		}
+		auto dropped = _dropped.exchange(0, std::memory_order_relaxed);
+		if (dropped > 0) {
+			LOG_WARN("trace exporter dropped ", dropped, " spans");
+		}
+		if (_stop.load()) {
+			std::lock_guard<std::mutex> lock(_mutex);
+			if (_pending.empty()) {
+				break;
+			}
+		}
+	}
+}
+
+void Tracer::Export(std::vector<std::unique_ptr<Span::Data>>& batch)
+{
+	std::string out;
+	JsonWriter writer(out);
+	writer.BeginObject().Key("resourceSpans").BeginArray().BeginObject();
+	writer.Key("resource").BeginObject().Key("attributes").BeginArray()
+		.BeginObject().Field("key", "service.name").Key("value").BeginObject().Field("stringValue", "GateServer").EndObject().EndObject()
+		.EndArray().EndObject();
+	writer.Key("scopeSpans").BeginArray().BeginObject();
+	writer.Key("scope").BeginObject().Field("name", "GateServer").EndObject();
+	writer.Key("spans").BeginArray();
+	for (const auto& span : batch) {
+		std::string trace_id;
+		AppendHex(trace_id, span->context.trace_id.data(), span->context.trace_id.size());
+		writer.BeginObject()
+			.Field("traceId", trace_id)
+			.Field("spanId", IdHex(span->context.span_id));
+		if (span->parent_id != 0) {
+			writer.Field("parentSpanId", IdHex(span->parent_id));
+		}
+		// OTLP JSON64λַʾ
+		writer.Field("name", span->name)
+			.Field("kind", static_cast<int>(span->kind))
+			.Field("startTimeUnixNano", std::to_string(span->start_ns))
+			.Field("endTimeUnixNano", std::to_string(span->end_ns));
+		writer.Key("attributes").BeginArray();
+		for (const auto& [key, value] : span->attributes) {
+			writer.BeginObject().Field("key", key).Key("value").BeginObject().Field("stringValue", value).EndObject().EndObject();
+		}
+		for (const auto& [key, value] : span->int_attributes) {
+			writer.BeginObject().Field("key", key).Key("value").BeginObject().Field("intValue", std::to_string(value)).EndObject().EndObject();
+		}
+		writer.EndArray();
+		writer.Key("status").BeginObject().Field("code", span->error ? 2 : 0);
+		if (span->error) {
+			writer.Field("message", span->error_message);
+		}
+		writer.EndObject();
+		writer.EndObject();
+	}
+	writer.EndArray().EndObject().EndArray().EndObject().EndArray().EndObject();
+	out.push_back('\n');
+
+	FILE* file = std::fopen(_file.c_str(), "ab");
+	if (file == nullptr) {
+		LOG_ERROR("open trace file ", _file, " failed");
+		return;
+	}
+	// MaxFileSizeʱѵǰļΪ<File>.1һдļ
+	std::fseek(file, 0, SEEK_END);
+	if (_max_file_size > 0 && std::ftell(file) + static_cast<long>(out.size()) > _max_file_size) {
+		std::fclose(file);
+		std::string rotated = _file + ".1";
+		std::remove(rotated.c_str());
+		std::rename(_file.c_str(), rotated.c_str());
+		file = std::fopen(_file.c_str(), "ab");
+		if (file == nullptr) {
+			LOG_ERROR("open trace file ", _file, " failed");
+			return;
+		}
+	}
+	std::fwrite(out.data(), 1, out.size(), file);
+	std::fclose(file);
+}
+
+void Tracer::Stop()
+{
+	bool expected = false;
+	if (!_stop.compare_exchange_strong(expected, true)) {
+		return;
+	}
+	_cond.notify_all();
+	if (_exporter.joinable()) {
+		_exporter.join();
+	}
+}
@@ -0,0 +1,112 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// ·ģW3C traceparentʽ00-<trace_id>-<span_id>-<flags>
+// ֻεtrace_id´¼κspan
+struct TraceContext {
+	std::array<std::uint8_t, 16> trace_id{};
+	std::uint64_t span_id = 0;
+	bool sampled = false;
+
+	bool Valid() const;
+	// traceparentͷֵ
+	std::string ToTraceParent() const;
+	// traceparentͷʽԷfalse
+	static bool FromTraceParent(std::string_view header, TraceContext& context);
+};
+
+enum class SpanKind : int {
+	Internal = 1,
+	Server = 2,
+	Client = 3,
+};
+
+// һκʱEndʱδʱʲôҲڴ
+class Span
+{
+public:
+	Span();
+	Span(const TraceContext& parent, std::string_view name, SpanKind kind = SpanKind::Internal);
+	~Span();
+	Span(Span&& other) noexcept;
+	Span& operator=(Span&& other) noexcept;
+	Span(const Span&) = delete;
+	Span& operator=(const Span&) = delete;
+
+	bool Recording() const { return _data != nullptr; }
+	// spanεʹõ
+	const TraceContext& Context() const { return _context; }
+
+	void SetName(std::string_view name);
+	void SetAttribute(std::string_view key, std::string_view value);
+	void SetAttribute(std::string_view key, std::int64_t value);
+	void SetError(std::string_view message);
+	void End();
+
+	struct Data;
+
+private:
+	friend class Tracer;
+	TraceContext _context;
+	std::unique_ptr<Data> _data;
+};
+
+// ͵config.ini[Trace]SampleRateTrustParentΪtrueʱtraceparentѲһ
+// spanɺ̨̰߳д뱾ļÿһOTLP JSONresourceSpansļMaxFileSizeMB0ƣʱת
+class Tracer
+{
+public:
+	// ˳ǰmainStopʣspanдȥ
+	static Tracer& Inst();
+
+	// ڵķspantraceparentΪͷֵΪ
+	Span StartRequest(std::string_view traceparent, std::string_view name);
+
+	// ǰ߳ϵģں̳߳ûʽεĵãMysqlDaoÿ
+	static const TraceContext& Current();
+	class ScopedContext {
+	public:
+		explicit ScopedContext(const TraceContext& context);
+		~ScopedContext();
+		ScopedContext(const ScopedContext&) = delete;
+		ScopedContext& operator=(const ScopedContext&) = delete;
+	private:
+		TraceContext _saved;
+	};
+
+	void Stop();
+
+private:
+	friend class Span;
+	Tracer();
+	Tracer(const Tracer&) = delete;
+	Tracer& operator=(const Tracer&) = delete;
+
+	void Submit(std::unique_ptr<Span::Data> span);
+	void Run();
+	void Export(std::vector<std::unique_ptr<Span::Data>>& batch);
+
+	static constexpr std::size_t MAX_PENDING = 16384;	// дļʱ
+	static constexpr std::size_t BATCH_SIZE = 512;
+
+	double _sample_rate = 0;
+	bool _trust_parent = false;		// ǷtraceparentĲ־
+	long _max_file_size = 0;		// ļĴСޣֽ
+	std::string _file;
+	std::mutex _mutex;
+	std::condition_variable _cond;
+	std::vector<std::unique_ptr<Span::Data>> _pending;
+	std::atomic<bool> _stop{ false };
+	std::atomic<std::uint64_t> _dropped{ 0 };
+	std::thread _exporter;
+};
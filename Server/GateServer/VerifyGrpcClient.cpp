@@ -1,19 +1,388 @@
 #include "VerifyGrpcClient.h"
+#include "BackendExecutor.h"
+#include <grpcpp/alarm.h>
+#include <algorithm>
 
+namespace {
+    std::chrono::milliseconds ReadMilliseconds(const std::string& section, const std::string& key,
+        std::chrono::milliseconds default_value) {
+        std::string value = ConfigMgr::Inst()[section][key];
+        if (value.empty()) {
+            return default_value;
+        }
+        return std::chrono::milliseconds(atoi(value.c_str()));
+    }
 
+    // p95ҪôԳ
+    constexpr std::uint64_t HEDGE_MIN_SAMPLES = 20;
+}
 
-VerifyGrpcClient::VerifyGrpcClient() {
-    ////  gRPC ͨ
-    //std::shared_ptr<Channel> channel = grpc::CreateChannel(
-    //    "127.0.0.1:50051",      // ַͶ˿
-    //    grpc::InsecureChannelCredentials()      // ʹ TLS 
-    //);                          
+VerifyCallPolicy VerifyCallPolicy::Load(const std::string& section)
+{
+    auto& cfg = ConfigMgr::Inst();
+    VerifyCallPolicy policy;
+    policy.timeout = ReadMilliseconds(section, "Timeout", policy.timeout);
+    std::string attempts = cfg[section]["MaxAttempts"];
+    if (!attempts.empty()) {
+        policy.max_attempts = std::max(1, atoi(attempts.c_str()));
+    }
+    policy.backoff = ReadMilliseconds(section, "RetryBackoff", policy.backoff);
+    policy.backoff_max = std::max(policy.backoff, ReadMilliseconds(section, "RetryBackoffMax", policy.backoff_max));
+    std::string hedge = cfg[section]["HedgeDelay"];
+    if (hedge == "p95") {
+        policy.hedge_p95 = true;
+    }
+    else if (!hedge.empty()) {
+        policy.hedge_delay = std::chrono::milliseconds(atoi(hedge.c_str()));
+    }
+    std::string coalesce = cfg[section]["Coalesce"];
+    policy.coalesce = !(coalesce == "false" || coalesce == "0");
+    policy.result_cache = ReadMilliseconds(section, "ResultCacheTime", policy.result_cache);
+    return policy;
+}
 
-    //// stubڵԶ̷
-    //stub_ = VerifyService::NewStub(channel);
+// CompletionQueueϵtagCqEventcq_߳ȡOnCompleteͷ
+struct VerifyGrpcClient::CqEvent {
+    virtual ~CqEvent() = default;
+    virtual void OnComplete(bool ok) = 0;
+};
 
-    auto& gCfgMgr = ConfigMgr::Inst();
-    std::string host = gCfgMgr["VarifyServer"]["Host"];
-    std::string port = gCfgMgr["VarifyServer"]["Port"];
-    pool_.reset(new RPConPool(5, host, port));
-}
\ No newline at end of file
+// һGetVerifyCodeãܰԺͶԳĶγԣһɹĳԽã
+// ȫʧҲʱһʧֶܽmutex
+struct VerifyGrpcClient::Call {
+    VerifyGrpcClient* client = nullptr;
+    std::mutex mutex;
+    GetVerifyReq request;
+    TraceContext trace;
+    std::chrono::steady_clock::time_point start;
+    std::chrono::system_clock::time_point deadline;
+    int attempts = 0;                       // ѷĳ
+    bool finished = false;
+    std::vector<ClientContext*> running;    // ;ĳԣýʱȡ
+    grpc::Alarm* hedge_alarm = nullptr;     // ûĶԳ嶨ʱýʱȡ
+    // ѽͶݻЭڵִ
+    std::function<void(GetVerifyRsp)> done;
+};
+
+struct VerifyGrpcClient::Attempt : CqEvent {
+    std::shared_ptr<Call> call;
+    bool hedge = false;
+    ClientContext context;
+    GetVerifyRsp reply;
+    Status status;
+    std::unique_ptr<grpc::ClientAsyncResponseReader<GetVerifyRsp>> reader;
+
+    void OnComplete(bool ok) override {
+        call->client->OnAttemptDone(*this, ok);
+    }
+};
+
+// Ե˱ܻԳӳ
+struct VerifyGrpcClient::Timer : CqEvent {
+    std::shared_ptr<Call> call;
+    bool hedge = false;
+    grpc::Alarm alarm;
+
+    void OnComplete(bool ok) override {
+        call->client->OnTimer(*this, ok);
+    }
+};
+
+VerifyGrpcClient::VerifyGrpcClient()
+    // ͨڵһεʱӣﲻҪVerifyServerѾ
+    : channels_(GrpcChannelOptions::Load("VarifyServer"))
+    , b_stop_(false)
+    , policy_(VerifyCallPolicy::Load("VarifyServer"))
+    , breaker_("verify", CircuitBreakerOptions::Load("VarifyServer"))
+    , singleflight_("verify", policy_.result_cache)
+    , rng_(std::random_device{}())
+    , hedge_p95_ms_(0)
+    , in_flight_(Metrics::Inst().GetGauge("gate_verify_in_flight",
+        "VerifyServer calls started and not yet completed"))
+    , latency_(Metrics::Inst().GetHistogram("gate_verify_rpc_duration_seconds",
+        "VerifyServer call latency from start to completion, including retries and hedges"))
+    , retries_(Metrics::Inst().GetCounter("gate_verify_retries_total",
+        "VerifyServer attempts retried after UNAVAILABLE"))
+    , hedges_(Metrics::Inst().GetCounter("gate_verify_hedges_total",
+        "Hedged VerifyServer attempts sent"))
+    , hedge_wins_(Metrics::Inst().GetCounter("gate_verify_hedge_wins_total",
+        "VerifyServer calls answered by the hedged attempt"))
+    , timeouts_(Metrics::Inst().GetCounter("gate_verify_timeouts_total",
+        "VerifyServer calls that ran past the Timeout deadline"))
+{
+    Metrics::Inst().GetGauge("gate_verify_channels_ready", "VerifyServer channels in READY state", "",
+        [this]() { return static_cast<double>(channels_.Ready()); });
+    cq_thread_ = std::thread([this]() {
+        PollCompletionQueue();
+        });
+}
+
+VerifyGrpcClient::~VerifyGrpcClient() {
+    Stop();
+}
+
+void VerifyGrpcClient::Stop() {
+    {
+        std::unique_lock<std::shared_mutex> lock(stop_mutex_);
+        if (b_stop_) {
+            return;
+        }
+        b_stop_ = true;
+        cq_.Shutdown();
+    }
+    if (cq_thread_.joinable()) {
+        cq_thread_.join();
+    }
+}
+
+void VerifyGrpcClient::PollCompletionQueue() {
+    void* tag = nullptr;
+    bool ok = false;
+    while (cq_.Next(&tag, &ok)) {
+        std::unique_ptr<CqEvent> event(static_cast<CqEvent*>(tag));
+        event->OnComplete(ok);
+        RefreshHedgeDelay();
+    }
+}
+
+bool VerifyGrpcClient::TryStartAttempt(const std::shared_ptr<Call>& call, bool hedge) {
+    std::shared_lock<std::shared_mutex> lock(stop_mutex_);
+    if (b_stop_) {
+        return false;
+    }
+    auto attempt = std::make_unique<Attempt>();
+    attempt->call = call;
+    attempt->hedge = hedge;
+    if (call->trace.Valid()) {
+        attempt->context.AddMetadata("traceparent", call->trace.ToTraceParent());
+    }
+    if (policy_.timeout.count() > 0) {
+        // ÿγԶõޣԺͶԳ岻ӳܺʱ
+        attempt->context.set_deadline(call->deadline);
+    }
+    ++call->attempts;
+    call->running.push_back(&attempt->context);
+    attempt->reader = channels_.Next().PrepareAsyncGetVerifyCode(&attempt->context, call->request, &cq_);
+    attempt->reader->StartCall();
+    // attemptcq_߳
+    Attempt* raw = attempt.release();
+    raw->reader->Finish(&raw->reply, &raw->status, static_cast<CqEvent*>(raw));
+    return true;
+}
+
+bool VerifyGrpcClient::TrySetTimer(const std::shared_ptr<Call>& call, std::chrono::milliseconds delay, bool hedge) {
+    std::shared_lock<std::shared_mutex> lock(stop_mutex_);
+    if (b_stop_) {
+        return false;
+    }
+    auto timer = std::make_unique<Timer>();
+    timer->call = call;
+    timer->hedge = hedge;
+    Timer* raw = timer.release();
+    if (hedge) {
+        call->hedge_alarm = &raw->alarm;
+    }
+    raw->alarm.Set(&cq_, std::chrono::system_clock::now() + delay, static_cast<CqEvent*>(raw));
+    return true;
+}
+
+void VerifyGrpcClient::OnAttemptDone(Attempt& attempt, bool ok) {
+    Call& call = *attempt.call;
+    std::lock_guard<std::mutex> lock(call.mutex);
+    std::erase(call.running, &attempt.context);
+    if (call.finished) {
+        // һѾȻˣǱȡ
+        return;
+    }
+    grpc::StatusCode code = ok ? attempt.status.error_code() : grpc::StatusCode::UNAVAILABLE;
+    if (code == grpc::StatusCode::OK) {
+        if (attempt.hedge) {
+            hedge_wins_.Inc();
+        }
+        Finish(call, std::move(attempt.reply), code);
+        return;
+    }
+    if (!call.running.empty()) {
+        // г;Ľ
+        return;
+    }
+    if (code == grpc::StatusCode::UNAVAILABLE && call.attempts < policy_.max_attempts) {
+        auto wait = Backoff(call.attempts - 1);
+        if (std::chrono::system_clock::now() + wait < call.deadline && TrySetTimer(attempt.call, wait, false)) {
+            retries_.Inc();
+            return;
+        }
+    }
+    Finish(call, GetVerifyRsp(), code);
+}
+
+void VerifyGrpcClient::OnTimer(Timer& timer, bool ok) {
+    Call& call = *timer.call;
+    std::lock_guard<std::mutex> lock(call.mutex);
+    if (timer.hedge) {
+        call.hedge_alarm = nullptr;
+    }
+    if (call.finished) {
+        return;
+    }
+    if (timer.hedge) {
+        // ȡߵһγѾʧ˱ܣԽ
+        if (!ok || call.running.empty() || call.attempts >= policy_.max_attempts) {
+            return;
+        }
+        if (TryStartAttempt(timer.call, true)) {
+            hedges_.Inc();
+        }
+        return;
+    }
+    if (!ok || !TryStartAttempt(timer.call, false)) {
+        Finish(call, GetVerifyRsp(), grpc::StatusCode::UNAVAILABLE);
+    }
+}
+
+void VerifyGrpcClient::Finish(Call& call, GetVerifyRsp reply, grpc::StatusCode code) {
+    call.finished = true;
+    for (ClientContext* context : call.running) {
+        context->TryCancel();
+    }
+    if (call.hedge_alarm != nullptr) {
+        call.hedge_alarm->Cancel();
+    }
+    latency_.RecordDuration(std::chrono::steady_clock::now() - call.start);
+    in_flight_.Sub(1);
+    // ͬ汾һʧܺͷOK״ֻ̬RPCFailed
+    if (code != grpc::StatusCode::OK) {
+        if (code == grpc::StatusCode::DEADLINE_EXCEEDED) {
+            timeouts_.Inc();
+        }
+        reply = GetVerifyRsp();
+        reply.set_error(ErrorCodes::RPCFailed);
+    }
+    call.done(std::move(reply));
+}
+
+std::chrono::milliseconds VerifyGrpcClient::Backoff(int retry) {
+    // ָھfull jitterͬһʱ
+    auto cap = policy_.backoff;
+    for (int i = 0; i < retry && cap < policy_.backoff_max; ++i) {
+        cap *= 2;
+    }
+    cap = std::min(cap, policy_.backoff_max);
+    std::uniform_int_distribution<std::int64_t> dist(0, cap.count());
+    return std::chrono::milliseconds(dist(rng_));
+}
+
+std::chrono::milliseconds VerifyGrpcClient::HedgeDelay() const {
+    if (policy_.hedge_p95) {
+        return std::chrono::milliseconds(hedge_p95_ms_.load(std::memory_order_relaxed));
+    }
+    return policy_.hedge_delay;
+}
+
+void VerifyGrpcClient::RefreshHedgeDelay() {
+    if (!policy_.hedge_p95) {
+        return;
+    }
+    auto now = std::chrono::steady_clock::now();
+    if (now - hedge_refreshed_ < std::chrono::seconds(1)) {
+        return;
+    }
+    hedge_refreshed_ = now;
+    auto snapshot = latency_.Collect();
+    if (snapshot.count < HEDGE_MIN_SAMPLES) {
+        return;
+    }
+    // ֱͼ΢¼ȡ
+    std::int64_t p95_ms = static_cast<std::int64_t>((snapshot.Quantile(0.95) + 999) / 1000);
+    hedge_p95_ms_.store(std::max<std::int64_t>(p95_ms, 1), std::memory_order_relaxed);
+}
+
+GetVerifyRsp VerifyGrpcClient::GetvarifyCode(std::string email, const TraceContext& trace) {
+    GetVerifyRsp reply;         // Ӧ
+    if (!breaker_.Allow()) {
+        reply.set_error(ErrorCodes::RPCFailed);
+        return reply;
+    }
+    ClientContext context;      // ͻĶ
+    if (trace.Valid()) {
+        context.AddMetadata("traceparent", trace.ToTraceParent());
+    }
+    if (policy_.timeout.count() > 0) {
+        context.set_deadline(std::chrono::system_clock::now() + policy_.timeout);
+    }
+    GetVerifyReq request;       // 
+    request.set_email(email);   //  email ֶ
+
+    //  gRPC Զ̷
+    Status status = channels_.Next().GetVerifyCode(&context, request, &reply);
+    if (!status.ok()) {         //  RPC Ƿɹ
+        if (status.error_code() == grpc::StatusCode::DEADLINE_EXCEEDED) {
+            timeouts_.Inc();
+        }
+        reply.set_error(ErrorCodes::RPCFailed);  // ô
+    }
+    breaker_.OnResult(reply.error() == ErrorCodes::Success);
+    return reply;
+}
+
+net::awaitable<GetVerifyRsp> VerifyGrpcClient::AsyncGetvarifyCode(std::string email, TraceContext trace) {
+    GetVerifyRsp rsp;
+    if (!policy_.coalesce) {
+        rsp = co_await CallGetVerifyCode(email, trace);
+        co_return rsp;
+    }
+    // صȷŽco_awaitco_awaitʽﹹlambdaʱ
+    Singleflight<GetVerifyRsp>::Call call = [this, email, trace]() {
+        return CallGetVerifyCode(email, trace);
+        };
+    // ֻɹӦʧܵһµ
+    Singleflight<GetVerifyRsp>::Keep keep = [](const GetVerifyRsp& result) {
+        return result.error() == ErrorCodes::Success;
+        };
+    rsp = co_await singleflight_.Do(email, std::move(call), std::move(keep));
+    co_return rsp;
+}
+
+net::awaitable<GetVerifyRsp> VerifyGrpcClient::CallGetVerifyCode(std::string email, TraceContext trace) {
+    Span span(trace, "grpc VerifyService/GetVerifyCode", SpanKind::Client);
+    span.SetAttribute("rpc.system", "grpc");
+    if (!breaker_.Allow()) {
+        span.SetError("circuit open");
+        GetVerifyRsp rsp;
+        rsp.set_error(ErrorCodes::RPCFailed);
+        co_return rsp;
+    }
+    auto context = span.Context();
+    auto executor = co_await net::this_coro::executor;
+    GetVerifyRsp rsp = co_await net::async_initiate<const net::use_awaitable_t<>&, void(GetVerifyRsp)>(
+        [this, executor, &email, &context](auto handler) {
+            auto call = std::make_shared<Call>();
+            call->client = this;
+            call->request.set_email(email);
+            call->trace = context;
+            call->start = std::chrono::steady_clock::now();
+            call->deadline = policy_.timeout.count() > 0
+                ? std::chrono::system_clock::now() + policy_.timeout
+                : std::chrono::system_clock::time_point::max();
+            // Finishcq_߳ϵdoneЭ̻صԼִϻָ
+            call->done = MakeResumer(executor, std::move(handler));
+
+            std::lock_guard<std::mutex> lock(call->mutex);
+            in_flight_.Add(1);
+            if (!TryStartAttempt(call, false)) {
+                // ͻֹͣ
+                Finish(*call, GetVerifyRsp(), grpc::StatusCode::UNAVAILABLE);
+                return;
+            }
+            auto hedge_delay = HedgeDelay();
+            if (hedge_delay.count() > 0 && policy_.max_attempts > 1) {
+                TrySetTimer(call, hedge_delay, true);
+            }
+        }, net::use_awaitable);
+    // VerifyServerصĴ󣨱ԼRedisҲ˵⣬һʧ
+    breaker_.OnResult(rsp.error() == ErrorCodes::Success);
+    if (rsp.error() == ErrorCodes::RPCFailed) {
+        span.SetError("rpc failed");
+    }
+    co_return rsp;
+}
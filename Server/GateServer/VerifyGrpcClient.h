@@ -3,6 +3,14 @@
 #include "message.grpc.pb.h"    // ͨ protobuf ɵ gRPC ׮ͷļ
 #include "const.h"
 #include "Singleton.h"
+#include "GrpcChannelSet.h"
+#include "CircuitBreaker.h"
+#include "Singleflight.h"
+#include "Metrics.h"
+#include "Tracer.h"
+#include <random>
+#include <shared_mutex>
+#include <thread>
 
 using grpc::Channel;            // gRPC ͨͨ
 using grpc::Status;             // gRPC ״̬ɹ/ʧϢ
@@ -12,100 +20,96 @@ using message::GetVerifyReq;    // 
 using message::GetVerifyRsp;    // ӦϢ
 using message::VerifyService;   // gRPC ӿ
 
-class RPConPool {
-public:
-    RPConPool(size_t poolSize, std::string host, std::string port)
-        : poolSize_(poolSize), host_(host), port_(port), b_stop_(false) {
-        for (size_t i = 0; i < poolSize_; ++i) {
-            std::shared_ptr<Channel> channel = grpc::CreateChannel(host + ":" + port,
-                grpc::InsecureChannelCredentials());
-            connections_.push(VerifyService::NewStub(channel));
-        }
-    }
-    ~RPConPool() {
-        std::lock_guard<std::mutex> lock(mutex_);
-        Close();
-        while (!connections_.empty()) {
-            connections_.pop();
-        }
-    }
-    std::unique_ptr<VerifyService::Stub> getConnection() {
-        std::unique_lock<std::mutex> lock(mutex_);
-        cond_.wait(lock, [this] {
-            if (b_stop_) {
-                return true;
-            }
-            return !connections_.empty();
-            });
-        //ֱֹͣӷؿָ
-        if (b_stop_) {
-            return  nullptr;
-        }
-        auto context = std::move(connections_.front());
-        connections_.pop();
-        return context;
-    }
-    void returnConnection(std::unique_ptr<VerifyService::Stub> context) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        if (b_stop_) {
-            return;
-        }
-        connections_.push(std::move(context));
-        cond_.notify_one();
-    }
-    void Close() {
-        b_stop_ = true;
-        cond_.notify_all();
-    }
-private:
-    std::atomic<bool> b_stop_;
-    size_t poolSize_;
-    std::string host_;
-    std::string port_;
-    std::queue<std::unique_ptr<VerifyService::Stub>> connections_;
-    std::mutex mutex_;
-    std::condition_variable cond_;
+// VerifyServerõޡԺͶԳ壬ȡconfig.ini[VarifyServer]Σ
+//   Timeout          һεõޣ룩ԺͶԳ壬0ʾ
+//   MaxAttempts      ෢ĳһκͶԳ壬1ʾҲԳ
+//   RetryBackoff     һԵ˱ޣ룩֮ÿηʵʵȴ0֮ȡ
+//   RetryBackoffMax  ˱޵ֵ룩
+//   HedgeDelay       һγôã룩ûнٷһ0Գ壻
+//                    p95ʱȡɵúʱp95ʱԳ
+//   Coalesce         ͬһͬʱֻһãĽĬtrue
+//   ResultCacheTime  ɹĽ仺ã룩ڼظֱӷأ0
+// ֻUNAVAILABLEԣ˵ѾVerifyServerطܶ෢һʼ
+// ԳͬVerifyServerΪͬһ֤룬ĬϹر
+struct VerifyCallPolicy {
+    std::chrono::milliseconds timeout{ 0 };
+    int max_attempts = 1;
+    std::chrono::milliseconds backoff{ 50 };
+    std::chrono::milliseconds backoff_max{ 1000 };
+    std::chrono::milliseconds hedge_delay{ 0 };
+    bool hedge_p95 = false;
+    bool coalesce = true;
+    std::chrono::milliseconds result_cache{ 0 };
+
+    static VerifyCallPolicy Load(const std::string& section);
 };
 
+// VerifyServerͻˣȾ۶ѯֵ[VarifyServer] Channelsͨϣstub̰߳ȫģHTTP/2·ã
+// Э̰汾gRPC첽ӿڣרŵCompletionQueue߳ȡ¼ٰѽͶݻЭڵio_context
 class VerifyGrpcClient :public Singleton<VerifyGrpcClient>
 {
     friend class Singleton<VerifyGrpcClient>;
 public:
+    ~VerifyGrpcClient();
 
-    GetVerifyRsp GetvarifyCode(std::string email) {
-        ClientContext context;      // ͻĶ
-        GetVerifyRsp reply;         // Ӧ
-        GetVerifyReq request;       // 
-        request.set_email(email);   //  email ֶ
-
-        ////  gRPC Զ̷
-        //Status status = stub_->GetVerifyCode(&context, request, &reply);
+    // ͬãǰֻ̣߳io߳ϵĵ÷ʹ
+    // traceЧʱͨmetadatatraceparentVerifyServer
+    GetVerifyRsp GetvarifyCode(std::string email, const TraceContext& trace = {});
 
-        //if (status.ok()) {          //  RPC Ƿɹ
-        //    return reply;           // Ӧ
-        //}
-        //else {
-        //    reply.set_error(ErrorCodes::RPCFailed);  // ô
-        //    return reply;           // شӦ
-        //}
+    // Э̰汾ռú̳߳أʧܡ۶ϻͻֹͣʱerrorΪRPCFailed
+    // ͬһĲϲһãϲûԼgRPC span
+    net::awaitable<GetVerifyRsp> AsyncGetvarifyCode(std::string email, TraceContext trace = {});
 
-        auto stub = pool_->getConnection();
-        Status status = stub->GetVerifyCode(&context, request, &reply);
-        if (status.ok()) {
-            pool_->returnConnection(std::move(stub));
-            return reply;
-        }
-        else {
-            pool_->returnConnection(std::move(stub));
-            reply.set_error(ErrorCodes::RPCFailed);
-            return reply;
-        }
+    // ۶ڼΪtrue÷Բ׼ֱӷRPCFailed
+    bool BreakerOpen() const {
+        return breaker_.Rejecting();
     }
 
+    // ֹͣµã;ɺCompletionQueuẹ߳Timeoutʱһ
+    void Stop();
+
 private:
     VerifyGrpcClient();
 
-    // std::unique_ptr<VerifyService::Stub> stub_;
-    std::unique_ptr<RPConPool> pool_;
-};
+    struct CqEvent;
+    struct Call;
+    struct Attempt;
+    struct Timer;
+
+    // һξ۶첽ãԺͶԳ
+    net::awaitable<GetVerifyRsp> CallGetVerifyCode(std::string email, TraceContext trace);
+    // CompletionQueue̵߳ѭShutdown֮ȡʣ¼ŷ
+    void PollCompletionQueue();
+    // ºڳcall->mutexʱãTry*ڿͻֹͣʱfalse
+    bool TryStartAttempt(const std::shared_ptr<Call>& call, bool hedge);
+    bool TrySetTimer(const std::shared_ptr<Call>& call, std::chrono::milliseconds delay, bool hedge);
+    void OnAttemptDone(Attempt& attempt, bool ok);
+    void OnTimer(Timer& timer, bool ok);
+    void Finish(Call& call, GetVerifyRsp reply, grpc::StatusCode code);
+    // nǰĵȴʱ䣬ֻcq_߳ϵ
+    std::chrono::milliseconds Backoff(int retry);
+    // ǰĶԳӳ٣0ʾԳ
+    std::chrono::milliseconds HedgeDelay() const;
+    // HedgeDelayΪp95ʱcq_߳ÿ¼һ
+    void RefreshHedgeDelay();
 
+    GrpcChannelSet<VerifyService> channels_;
+    grpc::CompletionQueue cq_;
+    std::thread cq_thread_;
+    // ʱֹStopֶռ֤Shutdown֮󲻻cq_Ϸ
+    std::shared_mutex stop_mutex_;
+    bool b_stop_;
+    VerifyCallPolicy policy_;
+    // ۶õĽͳƣԺͶԳ岻
+    CircuitBreaker breaker_;
+    Singleflight<GetVerifyRsp> singleflight_;
+    std::mt19937 rng_;                              // ˱ֻܵcq_߳ʹ
+    std::atomic<std::int64_t> hedge_p95_ms_;
+    std::chrono::steady_clock::time_point hedge_refreshed_;
+    Gauge& in_flight_;
+    Histogram& latency_;
+    Counter& retries_;
+    Counter& hedges_;
+    Counter& hedge_wins_;
+    Counter& timeouts_;
+};
@@ -22,6 +22,7 @@
 #include <condition_variable>
 #include "ConfigMgr.h"
 #include "sw/redis++/redis++.h"
+#include "Logger.h"
 
 
 namespace beast = boost::beast;         // from <boost/beast.hpp>
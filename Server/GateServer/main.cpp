@@ -5,6 +5,9 @@
 #include "CServer.h"
 #include "const.h"
 #include "ConfigMgr.h"
+#include "AsioIOContextPool.h"
+#include "Tracer.h"
+#include "FakeBackend.h"
 
 int main()
 {
@@ -15,7 +18,10 @@ int main()
 
     try
     {
-        unsigned short port = static_cast<unsigned short>(8080);
+        // [FakeBackend]ڵļRedisVerifyServerҪ֮ǰ
+        FakeBackends::Start();
+
+        unsigned short port = gate_port;
         net::io_context ioc{ 1 };
 
         boost::asio::signal_set signals(ioc, SIGINT, SIGTERM);
@@ -26,13 +32,32 @@ int main()
             ioc.stop();
             });
 
-        std::make_shared<CServer>(ioc, port)->Start();
-        std::cout << "Gate Server listen on port: " << port << std::endl;
+        std::string reuse_port = gCfgMgr["GateServer"]["ReusePort"];
+        if ((reuse_port == "true" || reuse_port == "1") && CServer::SupportReusePort()) {
+            // ÿio߳ӵԼSO_REUSEPORT acceptorں˷ַ
+            auto pool = AsioIOContextPool::GetInstance();
+            for (std::size_t i = 0; i < pool->Size(); ++i) {
+                std::make_shared<CServer>(pool->GetIOContext(i), port, true)->Start();
+            }
+            std::cout << "Gate Server listen on port: " << port
+                << " with " << pool->Size() << " reuseport acceptors" << std::endl;
+        }
+        else {
+            std::make_shared<CServer>(ioc, port)->Start();
+            std::cout << "Gate Server listen on port: " << port << std::endl;
+        }
         ioc.run();
     }
     catch (std::exception const& e)
     {
         std::cerr << "Error: " << e.what() << std::endl;
+        FakeBackends::Stop();
+        Tracer::Inst().Stop();
+        Logger::Inst().Stop();
         return EXIT_FAILURE;
     }
+    FakeBackends::Stop();
+    // дʣspan첽־ʣ
+    Tracer::Inst().Stop();
+    Logger::Inst().Stop();
 }
\ No newline at end of file